@@ -0,0 +1,77 @@
+#include "BiquadDesign.h"
+
+BiquadCoefficients makePeakBiquad(double sampleRate, double frequency, double quality, double gainFactor)
+{
+    auto A = std::sqrt(juce::jmax(0.0, gainFactor));
+    auto omega = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+    auto alpha = std::sin(omega) / (quality * 2.0);
+    auto c2 = -2.0 * std::cos(omega);
+    auto a0 = 1.0 + alpha / A;
+
+    return { (1.0 + alpha * A) / a0, c2 / a0, (1.0 - alpha * A) / a0, c2 / a0, (1.0 - alpha / A) / a0 };
+}
+
+BiquadCoefficients makeHighPassBiquad(double sampleRate, double frequency, double quality)
+{
+    auto n = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    auto nSquared = n * n;
+    auto c1 = 1.0 / (1.0 + n / quality + nSquared);
+
+    return { c1, -2.0 * c1, c1, c1 * 2.0 * (nSquared - 1.0), c1 * (1.0 - n / quality + nSquared) };
+}
+
+BiquadCoefficients makeLowPassBiquad(double sampleRate, double frequency, double quality)
+{
+    auto n = 1.0 / std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    auto nSquared = n * n;
+    auto c1 = 1.0 / (1.0 + n / quality + nSquared);
+
+    return { c1, 2.0 * c1, c1, c1 * 2.0 * (1.0 - nSquared), c1 * (1.0 - n / quality + nSquared) };
+}
+
+std::complex<double> getResponseForFrequency(const BiquadCoefficients &c, double frequency, double sampleRate)
+{
+    auto z = std::polar(1.0, -juce::MathConstants<double>::twoPi * frequency / sampleRate); // z^-1 on the unit circle
+    return (c.b0 + z * (c.b1 + z * c.b2)) / (1.0 + z * (c.a1 + z * c.a2));
+}
+
+double getButterworthQuality(int order, int section)
+{
+    jassert(order % 2 == 0 && section < order / 2);
+    return 1.0 / (2.0 * std::cos((2.0 * section + 1.0) * juce::MathConstants<double>::pi / (order * 2.0)));
+}
+
+BiquadCoefficients makePeakBiquad(const ChainSettings &chainSettings, double sampleRate)
+{
+    return makePeakBiquad(sampleRate, chainSettings.peakFreq, chainSettings.peakQuality, juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+}
+
+BiquadCoefficients makeMidBiquad(const ChainSettings &chainSettings, double sampleRate)
+{
+    return makePeakBiquad(sampleRate, chainSettings.midFreq, chainSettings.midQuality, juce::Decibels::decibelsToGain(chainSettings.midGainInDecibels));
+}
+
+int makeLowCutBiquads(const ChainSettings &chainSettings, double sampleRate, BiquadCoefficients *sections)
+{
+    auto numSections = getNumCutSections(chainSettings.lowCutSlope);
+    for (int i = 0; i < numSections; ++i)
+        sections[i] = makeHighPassBiquad(sampleRate, chainSettings.lowCutFreq, getButterworthQuality(2 * numSections, i));
+    return numSections;
+}
+
+int makeHighCutBiquads(const ChainSettings &chainSettings, double sampleRate, BiquadCoefficients *sections)
+{
+    auto numSections = getNumCutSections(chainSettings.highCutSlope);
+    for (int i = 0; i < numSections; ++i)
+        sections[i] = makeLowPassBiquad(sampleRate, chainSettings.highCutFreq, getButterworthQuality(2 * numSections, i));
+    return numSections;
+}
+
+int makeChainBiquads(const ChainSettings &chainSettings, double sampleRate, BiquadCoefficients *sections)
+{
+    auto numSections = makeLowCutBiquads(chainSettings, sampleRate, sections);
+    sections[numSections++] = makePeakBiquad(chainSettings, sampleRate);
+    numSections += makeHighCutBiquads(chainSettings, sampleRate, sections + numSections);
+    sections[numSections++] = makeMidBiquad(chainSettings, sampleRate);
+    return numSections;
+}
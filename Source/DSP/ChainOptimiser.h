@@ -0,0 +1,52 @@
+#pragma once
+
+#include "BiquadDesign.h"
+
+//==============================================================================
+/**
+    What to actually run for a designed cascade: which sections can go, which pairs collapse into one, and in what
+    order the rest are best run. The response of the result stays within ChainPlan::tolerance dB of the cascade as
+    designed, at every frequency and in phase as well as magnitude.
+
+    Sections go when their response is flat to within the tolerance (a Peak or Mid at 0 dB, near enough). A pair
+    goes down to one section when one section's zeros sit on the other's poles (a Peak and a Mid on the same
+    frequency and Q with opposite gains): the first's poles with the second's zeros and both gains take the first
+    one's place, and are often flat in turn. Engines that rebuild their cascade from scratch can also run what's
+    left in `order`, the most resonant sections first, which is the order least sensitive to rounding; the ones
+    that keep a filter's state across parameter changes keep their sections where they are.
+
+    Those checks are bounds, not samples of the response. A section N/D differs from 1 by (N - D)/D, which is at
+    most (|b0 - 1| + |b1 - a1| + |b2 - a2|) / min|D| anywhere on the unit circle, and min|D| has a closed form; a
+    pair is checked the same way on the first's zeros over the second's poles. Every drop and merge spends part of
+    one budget, so the tolerance holds for the plan as a whole rather than per step.
+
+    Planning doesn't allocate, so it can run on the audio thread, but it isn't cheap: each merge step bounds every
+    ordered pair of sections still in use, each bound with a log10, so a full chain of 18 sections costs up to
+    18 x 17 of them per step and up to 9 steps (a few thousand at worst, though it stops at the first step that
+    finds nothing to merge). Plan when the design changes, not every block.
+*/
+struct ChainPlan
+{
+    static constexpr double tolerance = 0.01; // dB
+
+    BiquadCoefficients sections[maxChainSections]; // as designed, or the merged section in place of the first of a pair
+    bool used[maxChainSections] {};                // false for a section dropped as flat or merged into another
+    int mergedInto[maxChainSections] {};           // the section that took this one over, -1 if none (or dropped as flat)
+    int order[maxChainSections] {};                // the used sections, poles closest to the unit circle first
+    int numSections = 0, numUsed = 0;
+
+    // True when both plans merge the same pairs, i.e. a filter running one can switch to the other without its state
+    // standing for a different signal
+    bool hasSameMerges(const ChainPlan &other) const noexcept;
+};
+
+// Plans a cascade laid out the way makeChainBiquads writes it (any list of normalised sections works).
+void planChain(const BiquadCoefficients *sections, int numSections, ChainPlan &plan) noexcept;
+
+// Bypasses the cut stages the plan drops and loads its merged sections, in a MonoChain already loaded with the
+// sections it was planned from. Peak and Mid are left to the caller, which owns those positions' bypass (see
+// isPeakUsed/isMidUsed). A section dropped as flat has an all-zero state, so one that the previous plan for this
+// chain dropped and this one doesn't is reset to that rather than resuming from whatever it last held.
+void applyPlan(MonoChain &chain, const ChainSettings &chainSettings, const ChainPlan &plan, const ChainPlan &previous);
+bool isPeakUsed(const ChainSettings &chainSettings, const ChainPlan &plan) noexcept;
+bool isMidUsed(const ChainPlan &plan) noexcept;
@@ -0,0 +1,40 @@
+#include "ChainTransition.h"
+
+void ChainTransition::prepare (const juce::dsp::ProcessSpec &spec, double fadeSeconds, double preRollSeconds)
+{
+    historyLength = juce::jmax(1, juce::roundToInt(preRollSeconds * spec.sampleRate));
+    fadeLength = juce::jmax(1, juce::roundToInt(fadeSeconds * spec.sampleRate));
+
+    history.setSize((int) spec.numChannels, historyLength);
+    scratch.setSize(2, juce::jmax((int) spec.maximumBlockSize, historyLength)); // mono chains get a view of channel 0 alone, stereo ones both
+    historyWritePosition.assign(spec.numChannels, 0);
+
+    reset();
+}
+
+void ChainTransition::reset()
+{
+    history.clear();
+    std::fill(historyWritePosition.begin(), historyWritePosition.end(), 0);
+    fadePosition = fadeLength;
+}
+
+void ChainTransition::recordInput (const juce::dsp::AudioBlock<float> &channelBlock, int channel)
+{
+    auto numSamples = (int) channelBlock.getNumSamples();
+    auto *input = channelBlock.getChannelPointer(0);
+    auto *recorded = history.getWritePointer(channel);
+    auto &writePosition = historyWritePosition[(size_t) channel];
+
+    if (numSamples > historyLength) // only the newest samples can ever be replayed
+    {
+        input += numSamples - historyLength;
+        numSamples = historyLength;
+    }
+
+    auto firstPart = juce::jmin(numSamples, historyLength - writePosition);
+    std::copy(input, input + firstPart, recorded + writePosition);
+    std::copy(input + firstPart, input + numSamples, recorded);
+
+    writePosition = (writePosition + numSamples) % historyLength;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+    Crossfades from the chain that is currently heard to a second, pre-warmed chain.
+
+    Used for changes that would click if they were applied in place (switching a cut slope
+    un-bypasses stages that still hold stale state, a preset load swaps every coefficient at once).
+    While idle it only keeps a short history of the input, so the steady-state cost is a copy per block;
+    the second chain is only run while a fade is in flight.
+*/
+class ChainTransition
+{
+public:
+    void prepare (const juce::dsp::ProcessSpec &spec, double fadeSeconds = 0.02, double preRollSeconds = 0.05);
+    void reset();
+
+    bool isActive() const noexcept { return fadePosition < fadeLength; }
+    int getFadeLength() const noexcept { return fadeLength; }
+
+    // Clears the incoming chain and runs the recorded input history through it so it enters the fade settled.
+    // Call this for every channel before start(), and before recordInput() for the current block.
+    template<typename ChainType>
+    void prewarm (ChainType &incoming, int channel)
+    {
+        incoming.reset();
+
+        // The oldest sample in the history sits at the write position, so unroll the ring into scratch in time order
+        auto *preRoll = scratch.getWritePointer(0);
+        auto *recorded = history.getReadPointer(channel);
+        auto writePosition = historyWritePosition[(size_t) channel];
+
+        std::copy(recorded + writePosition, recorded + historyLength, preRoll);
+        std::copy(recorded, recorded + writePosition, preRoll + (historyLength - writePosition));
+
+        auto preRollBlock = juce::dsp::AudioBlock<float>(scratch).getSingleChannelBlock(0).getSubBlock(0, (size_t) historyLength);
+        juce::dsp::ProcessContextReplacing<float> context(preRollBlock);
+        incoming.process(context);
+    }
+
+    // The same for a chain that takes both channels of a stereo pair at once, process(left, right, numSamples)
+    template<typename StereoChainType>
+    void prewarmStereo (StereoChainType &incoming)
+    {
+        incoming.reset();
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            auto *preRoll = scratch.getWritePointer(channel);
+            auto *recorded = history.getReadPointer(channel);
+            auto writePosition = historyWritePosition[(size_t) channel];
+
+            std::copy(recorded + writePosition, recorded + historyLength, preRoll);
+            std::copy(recorded, recorded + writePosition, preRoll + (historyLength - writePosition));
+        }
+
+        incoming.process(scratch.getWritePointer(0), scratch.getWritePointer(1), historyLength);
+    }
+
+    void start() noexcept { fadePosition = 0; }
+
+    // Keeps the last few milliseconds of input for the next prewarm
+    void recordInput (const juce::dsp::AudioBlock<float> &channelBlock, int channel);
+
+    // Runs both chains over one channel and blends live -> incoming in place. Call advance() once all channels are done.
+    // The two can be different kinds of mono chain, as when the plugin hands over to or from its render cache chains.
+    template<typename LiveChainType, typename IncomingChainType>
+    void process (LiveChainType &live, IncomingChainType &incoming, juce::dsp::AudioBlock<float> &channelBlock)
+    {
+        auto numSamples = (int) channelBlock.getNumSamples();
+        auto chunkSize = scratch.getNumSamples(); // hosts are allowed to send blocks larger than the prepared size
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            auto length = juce::jmin(chunkSize, numSamples - start);
+            auto liveBlock = channelBlock.getSubBlock((size_t) start, (size_t) length);
+            auto incomingBlock = juce::dsp::AudioBlock<float>(scratch).getSingleChannelBlock(0).getSubBlock(0, (size_t) length);
+            incomingBlock.copyFrom(liveBlock);
+
+            juce::dsp::ProcessContextReplacing<float> liveContext(liveBlock);
+            juce::dsp::ProcessContextReplacing<float> incomingContext(incomingBlock);
+            live.process(liveContext);
+            incoming.process(incomingContext);
+
+            // Both chains filter the same input so their outputs are correlated, which makes a linear fade the right one
+            auto *output = liveBlock.getChannelPointer(0);
+            auto *target = incomingBlock.getChannelPointer(0);
+            for (int i = 0; i < length; ++i)
+            {
+                auto gain = juce::jmin(1.f, float(fadePosition + start + i) / float(fadeLength));
+                output[i] += gain * (target[i] - output[i]);
+            }
+        }
+    }
+
+    // Both channels of a stereo pair at once, for chains like MidSideChain. Call advance() afterwards. Either side can
+    // be a StereoChainPair, to crossfade between a stereo chain and two mono ones.
+    template<typename LiveChainType, typename IncomingChainType>
+    void processStereo (LiveChainType &live, IncomingChainType &incoming, juce::dsp::AudioBlock<float> &leftBlock, juce::dsp::AudioBlock<float> &rightBlock)
+    {
+        auto numSamples = (int) leftBlock.getNumSamples();
+        auto chunkSize = scratch.getNumSamples();
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            auto length = juce::jmin(chunkSize, numSamples - start);
+            float *outputs[] = { leftBlock.getChannelPointer(0) + start, rightBlock.getChannelPointer(0) + start };
+            float *targets[] = { scratch.getWritePointer(0), scratch.getWritePointer(1) };
+
+            std::copy(outputs[0], outputs[0] + length, targets[0]);
+            std::copy(outputs[1], outputs[1] + length, targets[1]);
+            live.process(outputs[0], outputs[1], length);
+            incoming.process(targets[0], targets[1], length);
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                auto *output = outputs[channel];
+                auto *target = targets[channel];
+                for (int i = 0; i < length; ++i)
+                {
+                    auto gain = juce::jmin(1.f, float(fadePosition + start + i) / float(fadeLength));
+                    output[i] += gain * (target[i] - output[i]);
+                }
+            }
+        }
+    }
+
+    void advance (int numSamples) noexcept { fadePosition = juce::jmin(fadePosition + numSamples, fadeLength); }
+
+private:
+    juce::AudioBuffer<float> history, scratch;
+    std::vector<int> historyWritePosition;
+    int historyLength = 0, fadeLength = 0, fadePosition = 0;
+};
+
+// A left and a right mono chain seen as one stereo chain, process(left, right, numSamples), for processStereo()
+template<typename ChainType>
+struct StereoChainPair
+{
+    ChainType &left, &right;
+
+    void reset() { left.reset(); right.reset(); }
+
+    void process (float *leftSamples, float *rightSamples, int numSamples)
+    {
+        juce::dsp::AudioBlock<float> leftBlock(&leftSamples, 1, (size_t) numSamples), rightBlock(&rightSamples, 1, (size_t) numSamples);
+        juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock), rightContext(rightBlock);
+        left.process(leftContext);
+        right.process(rightContext);
+    }
+};
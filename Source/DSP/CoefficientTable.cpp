@@ -0,0 +1,217 @@
+#include "CoefficientTable.h"
+
+namespace
+{
+    // Finds value on a grid starting at minimum. Returns false when it lies outside the grid.
+    bool findGridPosition(double value, double minimum, double step, size_t gridSize, size_t &index, double &fraction)
+    {
+        auto position = (value - minimum) / step;
+        if (!(position >= 0.0) || position > double(gridSize - 1))
+            return false;
+
+        // Parameter values sit on the grid apart from float rounding, so snap those rather than interpolate
+        auto nearest = std::round(position);
+        if (std::abs(position - nearest) < 1.0e-3)
+            position = nearest;
+
+        index = juce::jmin((size_t) position, gridSize - 2);
+        fraction = position - double(index);
+        return true;
+    }
+
+    void loadCutFilter(CutFilter &cut, const BiquadCoefficients *sections, int numSections)
+    {
+        // Same bypassing as updateCutFilter: the sections in use, from the first
+        for (int stage = 0; stage < maxCutSections; ++stage)
+        {
+            if (stage < numSections)
+                loadCoefficients(cut.getStage(stage), sections[stage]);
+
+            cut.setStageBypassed(stage, stage >= numSections);
+        }
+    }
+}
+
+std::shared_ptr<CoefficientTable> CoefficientTable::getFor(double sampleRate)
+{
+    static std::mutex lock;
+    static std::map<double, std::weak_ptr<CoefficientTable>> tables;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto &slot = tables[sampleRate];
+    if (auto existing = slot.lock())
+        return existing;
+
+    std::shared_ptr<CoefficientTable> table(new CoefficientTable(sampleRate));
+    slot = table;
+    table->schedule(WorkerPool::Priority::normal);
+    return table;
+}
+
+CoefficientTable::CoefficientTable(double rate)
+    : pool(WorkerPool::getShared()), sampleRate(rate)
+{
+    pool->add(*this);
+}
+
+CoefficientTable::~CoefficientTable()
+{
+    pool->remove(*this);
+}
+
+void CoefficientTable::run()
+{
+    auto numFrequencies = (size_t) juce::roundToInt((maximumFrequency - minimumFrequency) / frequencyStep) + 1;
+    auto numGains = (size_t) juce::roundToInt((maximumGain - minimumGain) / gainStep) + 1;
+
+    prewarp.resize(numFrequencies);
+    for (size_t i = 0; i < numFrequencies; ++i)
+    {
+        if ((i & 4095) == 0 && isCancelled())
+            return;
+
+        // Computed from the index rather than by accumulating steps, so each entry is the exact grid frequency
+        prewarp[i] = std::tan(juce::MathConstants<double>::pi * (minimumFrequency + double(i) * frequencyStep) / sampleRate);
+    }
+
+    gainRoot.resize(numGains);
+    for (size_t i = 0; i < numGains; ++i)
+        gainRoot[i] = std::sqrt(juce::Decibels::decibelsToGain(minimumGain + double(i) * gainStep));
+
+    for (int numSections = 1; numSections <= maxCutSections; ++numSections)
+        for (int section = 0; section < numSections; ++section)
+            butterworthQuality[numSections - 1][section] = getButterworthQuality(2 * numSections, section);
+
+    ready.store(true, std::memory_order_release);
+}
+
+double CoefficientTable::getPrewarp(float frequency) const noexcept
+{
+    size_t index;
+    double fraction;
+    if (!findGridPosition(frequency, minimumFrequency, frequencyStep, prewarp.size(), index, fraction))
+        return std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+
+    return prewarp[index] + fraction * (prewarp[index + 1] - prewarp[index]);
+}
+
+double CoefficientTable::getGainRoot(float gainInDecibels) const noexcept
+{
+    // Only 97 steps, so there's no need to interpolate: anything off the grid is simply computed
+    size_t index;
+    double fraction;
+    if (!findGridPosition(gainInDecibels, minimumGain, gainStep, gainRoot.size(), index, fraction) || fraction != 0.0)
+        return std::sqrt(juce::Decibels::decibelsToGain((double) gainInDecibels));
+
+    return gainRoot[index];
+}
+
+BiquadCoefficients CoefficientTable::makePeak(float frequency, float quality, float gainInDecibels) const noexcept
+{
+    // makePeakBiquad's sin/cos of omega, from t = tan(omega / 2)
+    auto t = getPrewarp(juce::jmax(frequency, 2.f));
+    auto tSquared = t * t;
+    auto sinOmega = 2.0 * t / (1.0 + tSquared);
+    auto cosOmega = (1.0 - tSquared) / (1.0 + tSquared);
+
+    auto A = getGainRoot(gainInDecibels);
+    auto alpha = sinOmega / (quality * 2.0);
+    auto c2 = -2.0 * cosOmega;
+    auto a0 = 1.0 + alpha / A;
+
+    return { (1.0 + alpha * A) / a0, c2 / a0, (1.0 - alpha * A) / a0, c2 / a0, (1.0 - alpha / A) / a0 };
+}
+
+BiquadCoefficients CoefficientTable::makePeak(const ChainSettings &chainSettings) const noexcept
+{
+    return makePeak(chainSettings.peakFreq, chainSettings.peakQuality, chainSettings.peakGainInDecibels);
+}
+
+BiquadCoefficients CoefficientTable::makeMid(const ChainSettings &chainSettings) const noexcept
+{
+    return makePeak(chainSettings.midFreq, chainSettings.midQuality, chainSettings.midGainInDecibels);
+}
+
+int CoefficientTable::makeLowCut(const ChainSettings &chainSettings, BiquadCoefficients *sections) const noexcept
+{
+    // makeHighPassBiquad with n taken from the table
+    auto numSections = getNumCutSections(chainSettings.lowCutSlope);
+    auto n = getPrewarp(chainSettings.lowCutFreq);
+    auto nSquared = n * n;
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        auto quality = butterworthQuality[numSections - 1][i];
+        auto c1 = 1.0 / (1.0 + n / quality + nSquared);
+        sections[i] = { c1, -2.0 * c1, c1, c1 * 2.0 * (nSquared - 1.0), c1 * (1.0 - n / quality + nSquared) };
+    }
+
+    return numSections;
+}
+
+int CoefficientTable::makeHighCut(const ChainSettings &chainSettings, BiquadCoefficients *sections) const noexcept
+{
+    // makeLowPassBiquad with n taken from the table
+    auto numSections = getNumCutSections(chainSettings.highCutSlope);
+    auto n = 1.0 / getPrewarp(chainSettings.highCutFreq);
+    auto nSquared = n * n;
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        auto quality = butterworthQuality[numSections - 1][i];
+        auto c1 = 1.0 / (1.0 + n / quality + nSquared);
+        sections[i] = { c1, 2.0 * c1, c1, c1 * 2.0 * (1.0 - nSquared), c1 * (1.0 - n / quality + nSquared) };
+    }
+
+    return numSections;
+}
+
+int CoefficientTable::makeChain(const ChainSettings &chainSettings, BiquadCoefficients *sections) const noexcept
+{
+    auto count = makeLowCut(chainSettings, sections);
+    sections[count++] = makePeak(chainSettings);
+    count += makeHighCut(chainSettings, sections + count);
+    sections[count++] = makeMid(chainSettings);
+    return count;
+}
+
+//==============================================================================
+void loadCoefficients(Filter &filter, const BiquadCoefficients &section)
+{
+    auto &coefficients = filter.coefficients;
+
+    // A default constructed Filter holds a first order pass-through, so the first load has to replace it
+    if (coefficients == nullptr || coefficients->getFilterOrder() != 2)
+    {
+        coefficients = new juce::dsp::IIR::Coefficients<float>((float) section.b0, (float) section.b1, (float) section.b2, 1.f, (float) section.a1, (float) section.a2);
+        return;
+    }
+
+    auto *raw = coefficients->getRawCoefficients();
+    raw[0] = (float) section.b0;
+    raw[1] = (float) section.b1;
+    raw[2] = (float) section.b2;
+    raw[3] = (float) section.a1;
+    raw[4] = (float) section.a2;
+}
+
+void updateChain(MonoChain &chain, const ChainSettings &chainSettings, const CoefficientTable &table)
+{
+    jassert(table.isReady());
+
+    BiquadCoefficients sections[maxChainSections];
+    table.makeChain(chainSettings, sections);
+    loadChain(chain, chainSettings, sections);
+}
+
+void loadChain(MonoChain &chain, const ChainSettings &chainSettings, const BiquadCoefficients *sections)
+{
+    auto numLowCut = getNumCutSections(chainSettings.lowCutSlope);
+    auto numHighCut = getNumCutSections(chainSettings.highCutSlope);
+
+    loadCutFilter(chain.get<ChainPositions::LowCut>(), sections, numLowCut);
+    loadCoefficients(chain.get<ChainPositions::Peak>(), sections[numLowCut]);
+    loadCutFilter(chain.get<ChainPositions::HighCut>(), sections + numLowCut + 1, numHighCut);
+    loadCoefficients(chain.get<ChainPositions::Mid>(), sections[numLowCut + 1 + numHighCut]);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "BiquadDesign.h"
+#include "WorkerPool.h"
+
+//==============================================================================
+/**
+    Precomputed design inputs for one sample rate, so a parameter change costs a few lookups and some
+    arithmetic instead of trig, pow and a heap allocation per section.
+
+    Every design this plugin uses only needs tan(pi * f / sampleRate) from the frequency (the cuts use it
+    directly and the peak's sin/cos follow from it), sqrt of the gain factor from the gain, and the
+    Butterworth Q per section. The parameters are quantised, so those are tabulated on the parameters' own
+    grids (0.1 Hz from 20 Hz to 20 kHz, 0.5 dB from -24 to +24 dB). Values between grid points are
+    interpolated and values outside it are computed directly, so any ChainSettings works.
+
+    Tables are shared by everything running at the same sample rate and are built on the shared WorkerPool;
+    until isReady() returns true, callers keep using the direct designs.
+*/
+class CoefficientTable : private WorkerPool::Job
+{
+public:
+    // Returns the table for this sample rate, starting to build it if nothing holds one yet
+    static std::shared_ptr<CoefficientTable> getFor(double sampleRate);
+
+    ~CoefficientTable() override;
+
+    double getSampleRate() const noexcept { return sampleRate; }
+    bool isReady() const noexcept { return ready.load(std::memory_order_acquire); }
+
+    BiquadCoefficients makePeak(float frequency, float quality, float gainInDecibels) const noexcept;
+    BiquadCoefficients makePeak(const ChainSettings &chainSettings) const noexcept;
+    BiquadCoefficients makeMid(const ChainSettings &chainSettings) const noexcept;
+    int makeLowCut(const ChainSettings &chainSettings, BiquadCoefficients *sections) const noexcept; // returns the number of sections written
+    int makeHighCut(const ChainSettings &chainSettings, BiquadCoefficients *sections) const noexcept;
+    int makeChain(const ChainSettings &chainSettings, BiquadCoefficients *sections) const noexcept; // laid out as makeChainBiquads does
+
+private:
+    explicit CoefficientTable(double sampleRate);
+    void run() override;
+
+    double getPrewarp(float frequency) const noexcept; // tan(pi * frequency / sampleRate)
+    double getGainRoot(float gainInDecibels) const noexcept; // sqrt(decibelsToGain(gainInDecibels))
+
+    static constexpr double minimumFrequency = 20.0, maximumFrequency = 20000.0, frequencyStep = 0.1;
+    static constexpr double minimumGain = -24.0, maximumGain = 24.0, gainStep = 0.5;
+
+    std::shared_ptr<WorkerPool> pool;
+    const double sampleRate;
+    std::vector<double> prewarp, gainRoot;
+    double butterworthQuality[maxCutSections][maxCutSections] {}; // [sections - 1][section]
+    std::atomic<bool> ready {false};
+};
+
+// Writes one section into a Filter's existing coefficients in place, without allocating (after the first time)
+void loadCoefficients(Filter &filter, const BiquadCoefficients &section);
+
+// Same as updateChain(chain, settings, sampleRate), designed from the table. Only call it once the table isReady().
+void updateChain(MonoChain &chain, const ChainSettings &chainSettings, const CoefficientTable &table);
+
+// Loads sections already designed, laid out the way makeChainBiquads writes them for these settings
+void loadChain(MonoChain &chain, const ChainSettings &chainSettings, const BiquadCoefficients *sections);
@@ -0,0 +1,202 @@
+#include "ConsoleEngine.h"
+
+void ConsoleEngine::prepare(double newSampleRate, int newMaximumBlockSize, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    maximumBlockSize = juce::jmax(1, newMaximumBlockSize);
+    numChannels = newNumChannels;
+
+    settings.resize((size_t) numChannels);
+    batches.resize((size_t) ((numChannels + laneWidth - 1) / laneWidth));
+    frames.assign((size_t) (maximumBlockSize * laneWidth), 0.f); // lanes past the last channel stay silent
+
+    for (auto &batch : batches)
+        batch.needsRedesign = true;
+
+    reset();
+}
+
+void ConsoleEngine::reset()
+{
+    for (auto &batch : batches)
+    {
+        for (auto &section : batch.sections)
+        {
+            std::fill(std::begin(section.s1), std::end(section.s1), 0.f);
+            std::fill(std::begin(section.s2), std::end(section.s2), 0.f);
+        }
+    }
+}
+
+void ConsoleEngine::setChannelSettings(int channel, const ChainSettings &chainSettings)
+{
+    settings[(size_t) channel] = chainSettings;
+    batches[(size_t) (channel / laneWidth)].needsRedesign = true;
+}
+
+void ConsoleEngine::redesign(Batch &batch, int firstChannel)
+{
+    // Gather the batch's parameters into lane arrays first, so that each design formula below is one loop across
+    // all the channels rather than a trip through makePeakFilter/FilterDesign per channel and section
+    double lowCutN[laneWidth], highCutN[laneWidth];
+    double peakOmega[laneWidth], peakA[laneWidth], peakQuality[laneWidth];
+    double midOmega[laneWidth], midA[laneWidth], midQuality[laneWidth];
+    int lowCutSections[laneWidth], highCutSections[laneWidth];
+
+    for (int lane = 0; lane < laneWidth; ++lane)
+    {
+        auto channel = firstChannel + lane;
+        auto valid = channel < numChannels; // padding lanes get flat settings
+        auto chainSettings = valid ? settings[(size_t) channel] : ChainSettings{};
+
+        lowCutN[lane] = valid ? chainSettings.lowCutFreq : 1000.0;
+        highCutN[lane] = valid ? chainSettings.highCutFreq : 1000.0;
+        lowCutSections[lane] = valid ? getNumCutSections(chainSettings.lowCutSlope) : 0;
+        highCutSections[lane] = valid ? getNumCutSections(chainSettings.highCutSlope) : 0;
+
+        peakOmega[lane] = valid ? chainSettings.peakFreq : 1000.0;
+        peakA[lane] = chainSettings.peakGainInDecibels;
+        peakQuality[lane] = chainSettings.peakQuality;
+        midOmega[lane] = valid ? chainSettings.midFreq : 1000.0;
+        midA[lane] = chainSettings.midGainInDecibels;
+        midQuality[lane] = chainSettings.midQuality;
+    }
+
+    const auto piOverSampleRate = juce::MathConstants<double>::pi / sampleRate;
+
+    for (int lane = 0; lane < laneWidth; ++lane)
+    {
+        lowCutN[lane] = std::tan(piOverSampleRate * lowCutN[lane]);
+        highCutN[lane] = 1.0 / std::tan(piOverSampleRate * highCutN[lane]);
+        peakOmega[lane] = 2.0 * piOverSampleRate * juce::jmax(peakOmega[lane], 2.0);
+        midOmega[lane] = 2.0 * piOverSampleRate * juce::jmax(midOmega[lane], 2.0);
+        peakA[lane] = std::pow(10.0, peakA[lane] / 40.0); // sqrt of the gain factor, straight from decibels
+        midA[lane] = std::pow(10.0, midA[lane] / 40.0);
+    }
+
+    auto store = [](Section &section, int lane, const BiquadCoefficients &c)
+    {
+        section.b0[lane] = (float) c.b0;
+        section.b1[lane] = (float) c.b1;
+        section.b2[lane] = (float) c.b2;
+        section.a1[lane] = (float) c.a1;
+        section.a2[lane] = (float) c.a2;
+    };
+
+    // Butterworth high/low pass sections, identity where a channel's slope doesn't reach this slot
+    auto designCut = [&](int firstSlot, const double *n, const int *numSections, bool isHighPass)
+    {
+        for (int k = 0; k < maxCutSections; ++k)
+        {
+            auto &section = batch.sections[firstSlot + k];
+            for (int lane = 0; lane < laneWidth; ++lane)
+            {
+                if (k >= numSections[lane])
+                {
+                    store(section, lane, {});
+                    continue;
+                }
+
+                auto nSquared = n[lane] * n[lane];
+                auto invQ = 1.0 / getButterworthQuality(2 * numSections[lane], k);
+                auto c1 = 1.0 / (1.0 + invQ * n[lane] + nSquared);
+                auto a1 = isHighPass ? c1 * 2.0 * (nSquared - 1.0) : c1 * 2.0 * (1.0 - nSquared);
+                store(section, lane, { c1, isHighPass ? -2.0 * c1 : 2.0 * c1, c1, a1, c1 * (1.0 - invQ * n[lane] + nSquared) });
+            }
+        }
+    };
+
+    auto designPeak = [&](int slot, const double *omega, const double *A, const double *quality)
+    {
+        auto &section = batch.sections[slot];
+        for (int lane = 0; lane < laneWidth; ++lane)
+        {
+            auto alpha = std::sin(omega[lane]) / (quality[lane] * 2.0);
+            auto c2 = -2.0 * std::cos(omega[lane]);
+            auto a0 = 1.0 + alpha / A[lane];
+            store(section, lane, { (1.0 + alpha * A[lane]) / a0, c2 / a0, (1.0 - alpha * A[lane]) / a0, c2 / a0, (1.0 - alpha / A[lane]) / a0 });
+        }
+    };
+
+    designCut(0, lowCutN, lowCutSections, true);
+    designPeak(peakSlot, peakOmega, peakA, peakQuality);
+    designCut(highCutSlot, highCutN, highCutSections, false);
+    designPeak(midSlot, midOmega, midA, midQuality);
+
+    // A lane whose section is flat (b == a, which includes identity and 0 dB peaks) passes audio through untouched
+    // with zero state, so clear its state and skip the section entirely when every lane is flat
+    batch.numActiveSlots = 0;
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        auto &section = batch.sections[slot];
+        auto active = false;
+
+        for (int lane = 0; lane < laneWidth; ++lane)
+        {
+            auto flat = isFlat(section.b0[lane], section.b1[lane], section.b2[lane], section.a1[lane], section.a2[lane]);
+            if (flat)
+                section.s1[lane] = section.s2[lane] = 0.f;
+            active = active || !flat;
+        }
+
+        if (active)
+            batch.activeSlots[batch.numActiveSlots++] = slot;
+    }
+
+    batch.needsRedesign = false;
+}
+
+void ConsoleEngine::processSection(Section &section, float *frames, int numSamples) noexcept
+{
+    // Transposed direct form II, the same structure as IIR::Filter, with every operation applied across all lanes
+    alignas(64) float s1[laneWidth], s2[laneWidth];
+    std::copy(std::begin(section.s1), std::end(section.s1), s1);
+    std::copy(std::begin(section.s2), std::end(section.s2), s2);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto *frame = frames + i * laneWidth;
+        for (int lane = 0; lane < laneWidth; ++lane)
+            frame[lane] = processBiquadSample(frame[lane], section.b0[lane], section.b1[lane], section.b2[lane],
+                                              section.a1[lane], section.a2[lane], s1[lane], s2[lane]);
+    }
+
+    std::copy(std::begin(s1), std::end(s1), section.s1);
+    std::copy(std::begin(s2), std::end(s2), section.s2);
+}
+
+void ConsoleEngine::process(float* const* channelData, int numSamples)
+{
+    for (size_t b = 0; b < batches.size(); ++b)
+        if (batches[b].needsRedesign)
+            redesign(batches[b], (int) b * laneWidth);
+
+    for (int start = 0; start < numSamples; start += maximumBlockSize)
+    {
+        auto blockSize = juce::jmin(maximumBlockSize, numSamples - start);
+
+        for (size_t b = 0; b < batches.size(); ++b)
+        {
+            auto &batch = batches[b];
+            auto firstChannel = (int) b * laneWidth;
+            auto numLanes = juce::jmin(laneWidth, numChannels - firstChannel);
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                auto *input = channelData[firstChannel + lane] + start;
+                for (int i = 0; i < blockSize; ++i)
+                    frames[(size_t) (i * laneWidth + lane)] = input[i];
+            }
+
+            for (int k = 0; k < batch.numActiveSlots; ++k)
+                processSection(batch.sections[batch.activeSlots[k]], frames.data(), blockSize);
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                auto *output = channelData[firstChannel + lane] + start;
+                for (int i = 0; i < blockSize; ++i)
+                    output[i] = frames[(size_t) (i * laneWidth + lane)];
+            }
+        }
+    }
+}
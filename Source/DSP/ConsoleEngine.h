@@ -0,0 +1,63 @@
+#pragma once
+
+#include "BiquadDesign.h"
+
+//==============================================================================
+/**
+    Runs many independent EQ channels (a console's worth of FiltEQs) in one pass.
+
+    Channels are grouped into batches of laneWidth. Within a batch every coefficient and every filter
+    state is stored structure-of-arrays, one lane per channel, so the inner loop of each section runs the
+    same instruction on laneWidth channels with different settings (16 floats = one AVX-512 or two AVX registers).
+    Sections a channel doesn't use hold identity coefficients, and a section no channel in the batch uses
+    is skipped entirely.
+
+    Settings changes are only stored by setChannelSettings; the coefficients for every changed channel are
+    redesigned together at the start of the next process() call. Both must be called from the same thread.
+*/
+class ConsoleEngine
+{
+public:
+    static constexpr int laneWidth = 16;
+
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+    void reset();
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    void setChannelSettings(int channel, const ChainSettings &chainSettings);
+    const ChainSettings& getChannelSettings(int channel) const { return settings[(size_t) channel]; }
+
+    // Filters numChannels separate mono signals in place
+    void process(float* const* channelData, int numSamples);
+
+private:
+    // Slots in MonoChain order: the low cut sections, Peak, the high cut sections, Mid
+    static constexpr int peakSlot = maxCutSections;
+    static constexpr int highCutSlot = maxCutSections + 1;
+    static constexpr int midSlot = 2 * maxCutSections + 1;
+    static constexpr int numSlots = maxChainSections;
+
+    struct alignas(64) Section
+    {
+        float b0[laneWidth], b1[laneWidth], b2[laneWidth], a1[laneWidth], a2[laneWidth];
+        float s1[laneWidth], s2[laneWidth];
+    };
+
+    struct Batch
+    {
+        Section sections[numSlots];
+        int activeSlots[numSlots];
+        int numActiveSlots = 0;
+        bool needsRedesign = true;
+    };
+
+    void redesign(Batch &batch, int firstChannel);
+    static void processSection(Section &section, float *frames, int numSamples) noexcept;
+
+    std::vector<ChainSettings> settings;
+    std::vector<Batch> batches;
+    std::vector<float> frames; // one block of a batch, interleaved so that each sample's lanes sit together
+    double sampleRate = 44100.0;
+    int maximumBlockSize = 0, numChannels = 0;
+};
@@ -0,0 +1,167 @@
+#include "Crossover.h"
+
+void Crossover::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void Crossover::reset()
+{
+    for (auto &split : splits)
+    {
+        split.shared.reset();
+        for (auto &svf : split.allPass)
+            svf.reset();
+        for (auto &svf : split.lowPass)
+            svf.reset();
+    }
+
+    for (auto &compensation : compensations)
+        for (auto &svf : compensation.sections)
+            svf.reset();
+
+    for (auto &correction : corrections)
+    {
+        std::fill(std::begin(correction.s1), std::end(correction.s1), 0.f);
+        std::fill(std::begin(correction.s2), std::end(correction.s2), 0.f);
+    }
+}
+
+void Crossover::setSection(TptSvf &svf, TptSvf::Mode mode, int section, double g)
+{
+    svf.setMode(mode, getButterworthQuality(2 * numSections, section));
+    svf.setCutoff(g);
+}
+
+void Crossover::setSplits(Type newType, int newNumBands, const float *frequencies)
+{
+    newNumBands = juce::jlimit(2, maxBands, newNumBands);
+    if (newType != type || newNumBands != numBands)
+    {
+        type = newType;
+        numBands = newNumBands;
+        numSections = type == Type::lr24 ? 1 : 2;
+        reset(); // the tree is wired differently now, so no state carries over meaningfully
+    }
+
+    float sorted[maxBands - 1];
+    std::copy(frequencies, frequencies + numBands - 1, sorted);
+    std::sort(sorted, sorted + numBands - 1);
+
+    double g[maxBands - 1];
+    for (int i = 0; i < numBands - 1; ++i)
+        g[i] = std::tan(juce::MathConstants<double>::pi * juce::jlimit(10.0, 0.49 * sampleRate, (double) sorted[i]) / sampleRate);
+
+    // Split order and which all pass goes where, matching process(): with four bands splits[0] is the middle
+    // frequency and the compensations are the outer two, otherwise splits run bottom up
+    double splitG[maxBands - 1], compensationG[2];
+    auto numCompensations = 0;
+
+    switch (numBands)
+    {
+        case 2: splitG[0] = g[0]; break;
+        case 3: splitG[0] = g[0]; splitG[1] = g[1]; compensationG[0] = g[1]; numCompensations = 1; break;
+        default: splitG[0] = g[1]; splitG[1] = g[0]; splitG[2] = g[2]; compensationG[0] = g[2]; compensationG[1] = g[0]; numCompensations = 2; break;
+    }
+
+    for (int i = 0; i < numBands - 1; ++i)
+    {
+        auto &split = splits[i];
+        setSection(split.shared, TptSvf::lowPass, 0, splitG[i]);
+
+        for (int k = 1; k < numSections; ++k)
+            setSection(split.allPass[k - 1], TptSvf::allPass, k, splitG[i]);
+
+        // The squared cascade runs sections 1..n-1, then 0..n-1 again, after the shared section
+        for (int k = 1; k < 2 * numSections; ++k)
+            setSection(split.lowPass[k - 1], TptSvf::lowPass, k % numSections, splitG[i]);
+    }
+
+    for (int i = 0; i < numCompensations; ++i)
+        for (int k = 0; k < numSections; ++k)
+            setSection(compensations[i].sections[k], TptSvf::allPass, k, compensationG[i]);
+}
+
+void Crossover::setBandCorrection(int band, const ChainSettings &chainSettings)
+{
+    auto &correction = corrections[band];
+    BiquadCoefficients designs[] = { makePeakBiquad(chainSettings, sampleRate), makeMidBiquad(chainSettings, sampleRate) };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        const auto &c = designs[i];
+        auto active = !isFlat(c); // 0 dB: skipped, with clear state for when it comes back
+        if (!active)
+            correction.s1[i] = correction.s2[i] = 0.f;
+
+        correction.coefficients[i] = c;
+        correction.active[i] = active;
+    }
+}
+
+void Crossover::Split::process(const float *input, float *low, float *high, int numSections, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        double lowPassOutput, allPassOutput;
+        shared.processLowAndAllPass(input[i], lowPassOutput, allPassOutput);
+
+        for (int k = 0; k < numSections - 1; ++k)
+            allPassOutput = allPass[k].processSample(allPassOutput);
+        for (int k = 0; k < 2 * numSections - 1; ++k)
+            lowPassOutput = lowPass[k].processSample(lowPassOutput);
+
+        // input is only read above, so either output may share its buffer
+        low[i] = (float) lowPassOutput;
+        high[i] = (float) (allPassOutput - lowPassOutput);
+    }
+}
+
+void Crossover::Compensation::process(float *samples, int numSections, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        double sample = samples[i];
+        for (int k = 0; k < numSections; ++k)
+            sample = sections[k].processSample(sample);
+        samples[i] = (float) sample;
+    }
+}
+
+void Crossover::Correction::process(float *samples, int numSamples) noexcept
+{
+    for (int k = 0; k < 2; ++k)
+    {
+        if (active[k])
+            processBiquad(coefficients[k], s1[k], s2[k], samples, numSamples);
+    }
+}
+
+void Crossover::process(const float *input, float* const* bandOutputs, int numSamples) noexcept
+{
+    switch (numBands)
+    {
+        case 2:
+            splits[0].process(input, bandOutputs[0], bandOutputs[1], numSections, numSamples);
+            break;
+
+        case 3:
+            splits[0].process(input, bandOutputs[0], bandOutputs[1], numSections, numSamples);
+            compensations[0].process(bandOutputs[0], numSections, numSamples);
+            splits[1].process(bandOutputs[1], bandOutputs[1], bandOutputs[2], numSections, numSamples);
+            break;
+
+        default:
+            // Middle split first: the low pair then needs the top split's all pass and the high pair the bottom one's
+            splits[0].process(input, bandOutputs[0], bandOutputs[2], numSections, numSamples);
+            compensations[0].process(bandOutputs[0], numSections, numSamples);
+            compensations[1].process(bandOutputs[2], numSections, numSamples);
+            splits[1].process(bandOutputs[0], bandOutputs[0], bandOutputs[1], numSections, numSamples);
+            splits[2].process(bandOutputs[2], bandOutputs[2], bandOutputs[3], numSections, numSamples);
+            break;
+    }
+
+    for (int band = 0; band < numBands; ++band)
+        corrections[band].process(bandOutputs[band], numSamples);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "BiquadDesign.h"
+#include "ModulatedBand.h"
+
+//==============================================================================
+/**
+    A 2-4 way Linkwitz-Riley crossover built from the cut filters' Butterworth sections, with Peak/Mid per band.
+
+    LR24 is the 12 dB/oct Butterworth section squared, LR48 the 24 dB/oct cascade squared. Each split's low and high
+    outputs sum to the Butterworth all pass, so only the low pass and the all pass are filtered and the high output
+    is their difference. The first section's integrators give the low pass and the all pass of the input in one
+    update, so an LR24 split costs two sections rather than four (LR48: five rather than eight).
+
+    Lower bands are passed through the all passes of the splits above them so every band comes out with the same
+    phase and the bands still sum flat. Four bands split in the middle first, so each all pass is run once on a
+    pair of bands rather than once per band.
+*/
+class Crossover
+{
+public:
+    enum class Type
+    {
+        lr24, lr48
+    };
+
+    static constexpr int maxBands = 4;
+
+    void prepare(double sampleRate);
+    void reset();
+
+    // frequencies holds numBands - 1 split points. They're sorted here, so automation moving one past another
+    // swaps which split is which instead of breaking the tree.
+    void setSplits(Type type, int numBands, const float *frequencies);
+    int getNumBands() const noexcept { return numBands; }
+
+    // Only the Peak and Mid fields are used
+    void setBandCorrection(int band, const ChainSettings &chainSettings);
+
+    // Writes numBands outputs, lowest first. input may be the same buffer as bandOutputs[0].
+    void process(const float *input, float* const* bandOutputs, int numSamples) noexcept;
+
+private:
+    static constexpr int maxSections = 2; // Butterworth sections per side: 1 for LR24, 2 for LR48
+
+    struct Split
+    {
+        TptSvf shared;                           // first section: low pass and all pass of the input
+        TptSvf allPass[maxSections - 1];         // the rest of the all pass
+        TptSvf lowPass[2 * maxSections - 1];     // the rest of the squared low pass cascade
+
+        void process(const float *input, float *low, float *high, int numSections, int numSamples) noexcept;
+    };
+
+    struct Compensation
+    {
+        TptSvf sections[maxSections];
+
+        void process(float *samples, int numSections, int numSamples) noexcept;
+    };
+
+    struct Correction
+    {
+        BiquadCoefficients coefficients[2];
+        float s1[2] = {}, s2[2] = {};
+        bool active[2] = {};
+
+        void process(float *samples, int numSamples) noexcept;
+    };
+
+    void setSection(TptSvf &svf, TptSvf::Mode mode, int section, double g);
+
+    Split splits[maxBands - 1];
+    Compensation compensations[2];
+    Correction corrections[maxBands];
+    double sampleRate = 44100.0;
+    Type type = Type::lr24;
+    int numBands = 2, numSections = 1;
+};
+
+// Per-band Peak/Mid parameters for bands 2 and up ("Band 2 Peak Gain", ...); band 1 uses the main Peak/Mid. attach()
+// looks them up once, so load() can run every block without building their IDs on the audio thread.
+struct BandCorrectionParameters
+{
+    std::atomic<float> *peakFreq = nullptr, *peakGain = nullptr, *peakQuality = nullptr;
+    std::atomic<float> *midFreq = nullptr, *midGain = nullptr, *midQuality = nullptr;
+
+    template<typename ParameterSource>
+    void attach(ParameterSource &source, int band)
+    {
+        juce::String prefix("Band " + juce::String(band + 1) + " ");
+
+        peakFreq = source.getRawParameterValue(prefix + "Peak Frequency");
+        peakGain = source.getRawParameterValue(prefix + "Peak Gain");
+        peakQuality = source.getRawParameterValue(prefix + "Peak Quality");
+        midFreq = source.getRawParameterValue(prefix + "Mid Frequency");
+        midGain = source.getRawParameterValue(prefix + "Mid Gain");
+        midQuality = source.getRawParameterValue(prefix + "Mid Quality");
+    }
+
+    // Only the Peak and Mid fields are set, as setBandCorrection() uses
+    ChainSettings load() const noexcept
+    {
+        ChainSettings settings;
+
+        settings.peakFreq = peakFreq->load();
+        settings.peakGainInDecibels = peakGain->load();
+        settings.peakQuality = peakQuality->load();
+        settings.midFreq = midFreq->load();
+        settings.midGainInDecibels = midGain->load();
+        settings.midQuality = midQuality->load();
+
+        return settings;
+    }
+};
@@ -0,0 +1,265 @@
+#include "FeedbackSuppressor.h"
+
+FeedbackSuppressor::FeedbackSuppressor()
+    : pool(WorkerPool::getShared())
+{
+}
+
+FeedbackSuppressor::~FeedbackSuppressor()
+{
+    pool->remove(*this);
+}
+
+void FeedbackSuppressor::prepare(double newSampleRate, int maximumBlockSize)
+{
+    pool->remove(*this);
+    sampleRate = newSampleRate;
+
+    // About 40 ms windows whatever the rate (2048 points at 44.1/48 kHz), hopping an eighth of that: fine enough to
+    // resolve a notch a twentieth of an octave wide down to a couple of hundred Hz, and a new frame every 5 ms
+    auto order = 11;
+    while (order < 14 && double(1 << order) < 0.04 * sampleRate)
+        ++order;
+
+    fftSize = 1 << order;
+    hopSize = fftSize / hopsPerWindow;
+    fft = std::make_unique<juce::dsp::FFT>(order);
+
+    sampleFifo.setTotalSize(juce::jmax(4 * fftSize, 4 * maximumBlockSize));
+    sampleBuffer.assign((size_t) sampleFifo.getTotalSize(), 0.f);
+    notchFifo.reset();
+
+    history.assign((size_t) fftSize, 0.f);
+    spectrum.assign((size_t) (2 * fftSize), 0.f);
+    window.resize((size_t) fftSize);
+    for (int i = 0; i < fftSize; ++i)
+        window[(size_t) i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * (float) i / (float) fftSize);
+
+    auto numBins = (size_t) (fftSize / 2 + 1);
+    levels.assign(numBins, -140.f);
+    previousLevels.assign(numBins, -140.f);
+    onsetLevels.assign(numBins, 0.f);
+    previousOnsetLevels.assign(numBins, 0.f);
+    persistence.assign(numBins, 0);
+    previousPersistence.assign(numBins, 0);
+
+    numNotches = 0;
+    numActive = 0;
+    analysisGeneration = generation.load();
+    publishPending = false;
+
+    pool->add(*this);
+}
+
+void FeedbackSuppressor::reset() noexcept
+{
+    // The analysis clears its notches when it sees the new generation, and anything it sent before is ignored
+    generation.fetch_add(1, std::memory_order_release);
+    numActive = 0;
+}
+
+void FeedbackSuppressor::process(float *left, float *right, int numSamples) noexcept
+{
+    auto currentGeneration = generation.load(std::memory_order_relaxed);
+    int start1, size1, start2, size2;
+
+    while (notchFifo.getNumReady() > 0)
+    {
+        notchFifo.prepareToRead(1, start1, size1, start2, size2);
+        const auto &set = notchSets[size1 > 0 ? start1 : start2];
+
+        if (set.generation == currentGeneration)
+        {
+            // Existing notches keep their state through a change of depth; new ones, and a full set's slot handed to
+            // a new frequency, start clear
+            for (int i = 0; i < set.numNotches; ++i)
+                if (i >= numActive || set.placements[i] != activePlacements[i])
+                    for (auto &channel : state)
+                        channel[i][0] = channel[i][1] = 0.f;
+
+            std::copy(set.notches, set.notches + set.numNotches, active);
+            std::copy(set.placements, set.placements + set.numNotches, activePlacements);
+            numActive = set.numNotches;
+        }
+
+        notchFifo.finishedRead(1);
+    }
+
+    float *channels[] = { left, right };
+    for (int c = 0; c < 2; ++c)
+    {
+        auto *samples = channels[c];
+        if (samples == nullptr)
+            continue;
+
+        for (int k = 0; k < numActive; ++k)
+            processBiquad(active[k], state[c][k][0], state[c][k][1], samples, numSamples);
+    }
+
+    // The analysis sees the output, so a notch that isn't deep enough yet still shows the peak growing. If it has
+    // fallen behind, the samples that don't fit are dropped; it only needs recent audio.
+    sampleFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    auto copyMono = [left, right, this](int source, int destination, int count)
+    {
+        for (int i = 0; i < count; ++i)
+            sampleBuffer[(size_t) (destination + i)] = right != nullptr ? 0.5f * (left[source + i] + right[source + i]) : left[source + i];
+    };
+
+    copyMono(0, start1, size1);
+    copyMono(size1, start2, size2);
+    sampleFifo.finishedWrite(size1 + size2);
+
+    if (sampleFifo.getNumReady() >= hopSize)
+        schedule(WorkerPool::Priority::high);
+}
+
+void FeedbackSuppressor::run()
+{
+    // Every whole hop that has arrived; a partial one waits for the block that completes it to ask again
+    while (sampleFifo.getNumReady() >= hopSize && !isCancelled())
+    {
+        int start1, size1, start2, size2;
+        sampleFifo.prepareToRead(hopSize, start1, size1, start2, size2);
+
+        std::copy(history.begin() + hopSize, history.end(), history.begin());
+        auto *newest = history.data() + (fftSize - hopSize);
+        std::copy(sampleBuffer.data() + start1, sampleBuffer.data() + start1 + size1, newest);
+        std::copy(sampleBuffer.data() + start2, sampleBuffer.data() + start2 + size2, newest + size1);
+        sampleFifo.finishedRead(size1 + size2);
+
+        analyse();
+    }
+}
+
+void FeedbackSuppressor::analyse()
+{
+    auto currentGeneration = generation.load(std::memory_order_acquire);
+    if (currentGeneration != analysisGeneration)
+    {
+        analysisGeneration = currentGeneration;
+        numNotches = 0;
+        std::fill(persistence.begin(), persistence.end(), 0);
+        publishPending = false;
+    }
+
+    std::fill(spectrum.begin(), spectrum.end(), 0.f);
+    for (int i = 0; i < fftSize; ++i)
+        spectrum[(size_t) i] = history[(size_t) i] * window[(size_t) i];
+
+    fft->performFrequencyOnlyForwardTransform(spectrum.data());
+
+    std::swap(levels, previousLevels);
+    std::swap(persistence, previousPersistence);
+    std::swap(onsetLevels, previousOnsetLevels);
+
+    // dBFS for a sine: its Hann windowed peak is amplitude * N / 4
+    auto numBins = fftSize / 2 + 1;
+    for (int k = 0; k < numBins; ++k)
+        levels[(size_t) k] = juce::Decibels::gainToDecibels(spectrum[(size_t) k] * 4.f / (float) fftSize, -140.f);
+
+    std::fill(persistence.begin(), persistence.end(), 0);
+
+    const auto peakThreshold = threshold.load(std::memory_order_relaxed);
+    const int near = 3, far = 8; // the surroundings: clear of a sine's main lobe, close enough to be "around" it
+    auto lowestBin = juce::jmax(far, (int) std::ceil(40.0 * fftSize / sampleRate));
+
+    for (int k = lowestBin; k < numBins - far; ++k)
+    {
+        auto level = levels[(size_t) k];
+        if (level < -70.f || level <= levels[(size_t) k - 1] || level < levels[(size_t) k + 1])
+            continue;
+
+        auto surroundings = 0.f;
+        for (int d = near; d <= far; ++d)
+            surroundings += levels[(size_t) (k - d)] + levels[(size_t) (k + d)];
+        surroundings /= float(2 * (far - near + 1));
+
+        if (level - surroundings < peakThreshold)
+            continue;
+
+        // Carry on the track from the last frame, which may have sat a bin either side. One that fell back by more
+        // than half a dB isn't growing and starts over. Growth only counts from the frame where the peak fills the
+        // whole window: before that any new tone seems to grow, just from more of it coming into view.
+        auto best = -1;
+        for (int d = -1; d <= 1; ++d)
+            if (previousPersistence[(size_t) (k + d)] > 0 && (best < 0 || previousPersistence[(size_t) (k + d)] > previousPersistence[(size_t) best]))
+                best = k + d;
+
+        if (best >= 0 && level >= previousLevels[(size_t) best] - 0.5f)
+        {
+            persistence[(size_t) k] = previousPersistence[(size_t) best] + 1;
+            onsetLevels[(size_t) k] = persistence[(size_t) k] == hopsPerWindow ? level : previousOnsetLevels[(size_t) best];
+        }
+        else
+        {
+            persistence[(size_t) k] = 1;
+            onsetLevels[(size_t) k] = level;
+        }
+
+        if (persistence[(size_t) k] >= hopsPerWindow + framesToConfirm && level - onsetLevels[(size_t) k] >= growthToConfirm)
+        {
+            // Parabolic interpolation over the log magnitudes puts the frequency within a fraction of a bin
+            auto below = levels[(size_t) k - 1], above = levels[(size_t) k + 1];
+            auto curvature = below - 2.f * level + above;
+            auto offset = curvature < 0.f ? 0.5f * (below - above) / curvature : 0.f;
+
+            placeNotch((k + offset) * sampleRate / fftSize);
+            persistence[(size_t) k] = 0; // a new track has to build up again before this notch goes deeper
+        }
+    }
+
+    if (publishPending)
+        publish();
+}
+
+void FeedbackSuppressor::placeNotch(double frequency)
+{
+    frequency = juce::jlimit(20.0, 0.45 * sampleRate, frequency);
+
+    for (int i = 0; i < numNotches; ++i)
+    {
+        if (std::abs(std::log2(frequency / notches[i].frequency)) < 1.0 / 12.0)
+        {
+            notches[i].gainInDecibels = juce::jmax(deepestCut, notches[i].gainInDecibels + cutStep);
+            publishPending = true;
+            return;
+        }
+    }
+
+    auto index = numNotches;
+    if (numNotches == maxNotches) // full: the shallowest (oldest of equals) makes way
+    {
+        index = 0;
+        for (int i = 1; i < numNotches; ++i)
+            if (notches[i].gainInDecibels > notches[index].gainInDecibels)
+                index = i;
+    }
+    else
+    {
+        ++numNotches;
+    }
+
+    notches[index] = { frequency, firstCut, ++numPlacements };
+    publishPending = true;
+}
+
+void FeedbackSuppressor::publish()
+{
+    if (notchFifo.getFreeSpace() < 1)
+        return; // the audio thread hasn't taken the last ones yet, try again next frame
+
+    int start1, size1, start2, size2;
+    notchFifo.prepareToWrite(1, start1, size1, start2, size2);
+    auto &set = notchSets[size1 > 0 ? start1 : start2];
+
+    for (int i = 0; i < numNotches; ++i)
+    {
+        set.notches[i] = makePeakBiquad(sampleRate, notches[i].frequency, notchQuality, juce::Decibels::decibelsToGain((double) notches[i].gainInDecibels));
+        set.placements[i] = notches[i].placement;
+    }
+
+    set.numNotches = numNotches;
+    set.generation = analysisGeneration;
+    notchFifo.finishedWrite(1);
+    publishPending = false;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "BiquadDesign.h"
+#include "WorkerPool.h"
+
+//==============================================================================
+/**
+    Finds feedback (narrow spectral peaks that keep growing) and notches it out, for live monitor mixes.
+
+    The audio thread filters through the current notches, pushes the result into a lock-free FIFO and, once a
+    hop's worth has arrived, asks the WorkerPool for a high priority run. That runs an FFT every hop and, for a
+    peak that has stood well above the spectrum around it and grown over several frames, places a narrow notch
+    there (or deepens the one already there). Coefficients are designed on the worker and handed over through a
+    second FIFO, so the audio thread only ever copies them in; each active notch costs it one biquad per channel.
+
+    Notches stay until reset(), like the fixed filters of a hardware feedback suppressor: feedback that has been
+    found once comes back the moment its notch is lifted.
+*/
+class FeedbackSuppressor : private WorkerPool::Job
+{
+public:
+    static constexpr int maxNotches = 16;
+
+    FeedbackSuppressor();
+    ~FeedbackSuppressor() override;
+
+    // Not while process() may run. Waits for an analysis in progress to finish.
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    // Drops every notch. Safe from the audio thread.
+    void reset() noexcept;
+
+    // How far (dB) a peak has to stand above the spectrum around it before it counts as feedback
+    void setThreshold(float decibels) noexcept { threshold.store(decibels, std::memory_order_relaxed); }
+
+    int getNumNotches() const noexcept { return numActive; }
+
+    void process(float *left, float *right, int numSamples) noexcept;
+
+private:
+    struct NotchSet
+    {
+        BiquadCoefficients notches[maxNotches];
+        juce::uint32 placements[maxNotches] {}; // see Notch::placement
+        int numNotches = 0;
+        juce::uint32 generation = 0; // reset() count the set was computed under, so a stale one is ignored
+    };
+
+    struct Notch
+    {
+        double frequency = 0;
+        float gainInDecibels = 0;
+        juce::uint32 placement = 0; // changes when the slot is given to a new frequency, but not when it's deepened
+    };
+
+    void run() override;
+    void analyse();
+    void placeNotch(double frequency);
+    void publish();
+
+    static constexpr float firstCut = -6.f, cutStep = -3.f, deepestCut = -18.f;
+    static constexpr double notchQuality = 30.0; // about 1/20 octave wide
+    static constexpr int hopsPerWindow = 8;
+    static constexpr int framesToConfirm = 4;     // hops of growth needed once the peak fills a whole window
+    static constexpr float growthToConfirm = 2.f; // dB it must have grown over them
+
+    std::shared_ptr<WorkerPool> pool;
+    double sampleRate = 44100.0;
+    std::atomic<float> threshold {15.f};
+    std::atomic<juce::uint32> generation {0};
+
+    // Audio thread side
+    juce::AbstractFifo sampleFifo {1}, notchFifo {8};
+    std::vector<float> sampleBuffer;
+    NotchSet notchSets[8];
+    BiquadCoefficients active[maxNotches];
+    juce::uint32 activePlacements[maxNotches] {};
+    float state[2][maxNotches][2] {}; // [channel][notch][s1, s2]
+    int numActive = 0;
+
+    // Worker side
+    std::unique_ptr<juce::dsp::FFT> fft;
+    int fftSize = 0, hopSize = 0;
+    std::vector<float> history, window, spectrum;
+    std::vector<float> levels, previousLevels, onsetLevels, previousOnsetLevels; // per bin, this frame and the last
+    std::vector<int> persistence, previousPersistence; // frames each bin's peak has been seen growing
+    Notch notches[maxNotches];
+    int numNotches = 0;
+    juce::uint32 analysisGeneration = 0, numPlacements = 0;
+    bool publishPending = false;
+};
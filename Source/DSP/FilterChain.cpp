@@ -0,0 +1,91 @@
+#include "FilterChain.h"
+
+Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate)
+{
+    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, chainSettings.peakFreq, chainSettings.peakQuality, juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+}
+
+Coefficients makeMidFilter(const ChainSettings &chainSettings, double sampleRate)
+{
+    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, chainSettings.midFreq, chainSettings.midQuality, juce::Decibels::decibelsToGain(chainSettings.midGainInDecibels));
+}
+
+namespace
+{
+    // A slope choice keeps the steep switch and the other way round. Choices 4-7 come from states saved while the slope
+    // parameters had all eight slopes, and set the whole slope.
+    Slope withChoice(float choice, Slope slope)
+    {
+        if (juce::roundToInt(choice) >= numSlopeChoices)
+            return static_cast<Slope>(juce::jlimit(0, (int) Slope_96, juce::roundToInt(choice)));
+        return makeSlope(choice, slope >= numSlopeChoices ? 1.f : 0.f);
+    }
+
+    Slope withSteep(float steep, Slope slope) { return makeSlope((float) (slope % numSlopeChoices), steep); }
+}
+
+bool setChainParameter(ChainSettings &settings, const juce::String &id, float value)
+{
+    if (id == "Low Cut Freq")         settings.lowCutFreq = value;
+    else if (id == "High Cut Freq")   settings.highCutFreq = value;
+    else if (id == "Peak Frequency")  settings.peakFreq = value;
+    else if (id == "Peak Gain")       settings.peakGainInDecibels = value;
+    else if (id == "Peak Quality")    settings.peakQuality = value;
+    else if (id == "Low Cut Slope")   settings.lowCutSlope = withChoice(value, settings.lowCutSlope);
+    else if (id == "High Cut Slope")  settings.highCutSlope = withChoice(value, settings.highCutSlope);
+    else if (id == "Low Cut Steep")   settings.lowCutSlope = withSteep(value, settings.lowCutSlope);
+    else if (id == "High Cut Steep")  settings.highCutSlope = withSteep(value, settings.highCutSlope);
+    else if (id == "Mid Frequency")   settings.midFreq = value;
+    else if (id == "Mid Gain")        settings.midGainInDecibels = value;
+    else if (id == "Mid Quality")     settings.midQuality = value;
+    else                              return false;
+    
+    return true;
+}
+
+//==============================================================================
+CutFilter::CutFilter() noexcept
+{
+    std::fill(std::begin(bypassed), std::end(bypassed), true); // nothing designed yet, so nothing runs
+}
+
+void CutFilter::setStageBypassed(int stage, bool shouldBeBypassed) noexcept
+{
+    bypassed[stage] = shouldBeBypassed;
+
+    numActive = 0;
+    for (int k = 0; k < maxCutSections; ++k)
+        if (!bypassed[k])
+            active[numActive++] = k;
+}
+
+void CutFilter::prepare(const juce::dsp::ProcessSpec &spec) noexcept
+{
+    jassert(spec.numChannels == 1);
+    juce::ignoreUnused(spec);
+    reset();
+}
+
+void CutFilter::reset() noexcept
+{
+    for (int stage = 0; stage < maxCutSections; ++stage)
+        resetStage(stage);
+}
+
+void CutFilter::resetStage(int stage) noexcept
+{
+    state[stage][0] = state[stage][1] = 0.f;
+}
+
+void updateCoefficients(Coefficients &old, const Coefficients &replacements)
+{
+    *old = *replacements;
+}
+
+void updateChain(MonoChain &chain, const ChainSettings &chainSettings, double sampleRate)
+{
+    updateCutFilter(chain.get<ChainPositions::LowCut>(), makeLowCutFilter(chainSettings, sampleRate), chainSettings.lowCutSlope);
+    updateCoefficients(chain.get<ChainPositions::Peak>().coefficients, makePeakFilter(chainSettings, sampleRate));
+    updateCutFilter(chain.get<ChainPositions::HighCut>(), makeHighCutFilter(chainSettings, sampleRate), chainSettings.highCutSlope);
+    updateCoefficients(chain.get<ChainPositions::Mid>().coefficients, makeMidFilter(chainSettings, sampleRate));
+}
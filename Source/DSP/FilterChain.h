@@ -0,0 +1,216 @@
+#pragma once
+
+// The DSP core only needs these two modules, so headless tools can link it without the plugin/GUI stack
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+*/
+
+enum Slope
+{
+    Slope_12, Slope_24, Slope_36, Slope_48, Slope_60, Slope_72, Slope_84, Slope_96
+};
+
+struct ChainSettings // Stores Parameter Settings, defaulting to the plugin's parameter defaults
+{
+    float midFreq{1000.f}, midGainInDecibels{0}, midQuality{1.f};
+    float peakFreq{2000.f}, peakGainInDecibels{0}, peakQuality{1.f};
+    float lowCutFreq {20.f}, highCutFreq {20000.f};
+    Slope lowCutSlope {Slope::Slope_12}, highCutSlope {Slope::Slope_12};
+};
+
+inline bool operator== (const ChainSettings &a, const ChainSettings &b)
+{
+    return a.midFreq == b.midFreq && a.midGainInDecibels == b.midGainInDecibels && a.midQuality == b.midQuality
+        && a.peakFreq == b.peakFreq && a.peakGainInDecibels == b.peakGainInDecibels && a.peakQuality == b.peakQuality
+        && a.lowCutFreq == b.lowCutFreq && a.highCutFreq == b.highCutFreq
+        && a.lowCutSlope == b.lowCutSlope && a.highCutSlope == b.highCutSlope;
+}
+
+inline bool operator!= (const ChainSettings &a, const ChainSettings &b) { return !(a == b); }
+
+// "Low/High Cut Slope" keep their original four choices, 12 to 48 dB/Oct, so host automation and saved sessions mean
+// what they always did. "Low/High Cut Steep" adds 48 dB/Oct on top, for 60 to 96.
+constexpr int numSlopeChoices = 4;
+
+inline Slope makeSlope(float choice, float steep) noexcept
+{
+    return static_cast<Slope>(juce::jlimit(0, numSlopeChoices - 1, juce::roundToInt(choice)) + (steep > 0.5f ? numSlopeChoices : 0));
+}
+
+// Loads the raw values of our parameters into ChainSettings. Works with anything that has getRawParameterValue(id)->load(),
+// which is how the plugin passes its AudioProcessorValueTreeState in without this library depending on juce_audio_processors
+template<typename ParameterSource>
+ChainSettings getChainSettings(ParameterSource &source)
+{
+    ChainSettings settings;
+    
+    settings.lowCutFreq = source.getRawParameterValue("Low Cut Freq")->load();
+    settings.highCutFreq = source.getRawParameterValue("High Cut Freq")->load();
+    settings.peakFreq = source.getRawParameterValue("Peak Frequency")->load();
+    settings.peakGainInDecibels = source.getRawParameterValue("Peak Gain")->load();
+    settings.peakQuality = source.getRawParameterValue("Peak Quality")->load();
+    settings.lowCutSlope = makeSlope(source.getRawParameterValue("Low Cut Slope")->load(), source.getRawParameterValue("Low Cut Steep")->load());
+    settings.highCutSlope = makeSlope(source.getRawParameterValue("High Cut Slope")->load(), source.getRawParameterValue("High Cut Steep")->load());
+    settings.midFreq = source.getRawParameterValue("Mid Frequency")->load();
+    settings.midGainInDecibels = source.getRawParameterValue("Mid Gain")->load();
+    settings.midQuality = source.getRawParameterValue("Mid Quality")->load();
+    
+    return settings;
+}
+
+// The other direction, for presets read without an AudioProcessorValueTreeState. Returns false if id isn't one of ours.
+bool setChainParameter(ChainSettings &settings, const juce::String &id, float value);
+
+using Filter = juce::dsp::IIR::Filter<float>; // type namespace to avoid always having to write out nested namespaces
+using MidFilter = juce::dsp::IIR::Filter<float>;
+constexpr int maxCutSections = 8; // one Filter per 12db/oct of slope, up to 96db/oct
+inline int getNumCutSections(Slope slope) { return slope + 1; }
+
+//==============================================================================
+/**
+    A Butterworth cut: up to maxCutSections second-order stages, of which the ones not bypassed run.
+
+    The stages' coefficients live in ordinary Filters, so they're designed and loaded as any other band, but the
+    filtering is done here. Each number of running stages has its own kernel, compiled for exactly that many, which
+    takes every sample through all of them before the next while coefficients and state sit in registers: nothing
+    in the loop checks a bypass flag, and a 96db/oct cut costs one pass over the block rather than eight. process()
+    picks the kernel from the count once per block.
+
+    Mono, like IIR::Filter. Stages run in index order, so dropping one (see applyPlan) leaves the others' state alone.
+*/
+class CutFilter
+{
+public:
+    CutFilter() noexcept;
+
+    Filter& getStage(int stage) noexcept { return stages[stage]; }
+    const Filter& getStage(int stage) const noexcept { return stages[stage]; }
+
+    void setStageBypassed(int stage, bool shouldBeBypassed) noexcept;
+    bool isStageBypassed(int stage) const noexcept { return bypassed[stage]; }
+    int getNumActiveStages() const noexcept { return numActive; }
+
+    void prepare(const juce::dsp::ProcessSpec &spec) noexcept;
+    void reset() noexcept;
+    void resetStage(int stage) noexcept;
+
+    template<typename ProcessContext>
+    void process(const ProcessContext &context) noexcept
+    {
+        const auto &inputBlock = context.getInputBlock();
+        auto &outputBlock = context.getOutputBlock();
+        jassert(inputBlock.getNumChannels() == 1 && outputBlock.getNumChannels() == 1);
+
+        auto numSamples = (int) outputBlock.getNumSamples();
+        const auto *input = inputBlock.getChannelPointer(0);
+        auto *output = outputBlock.getChannelPointer(0);
+
+        if (context.isBypassed || numActive == 0)
+        {
+            if (input != output)
+                std::copy(input, input + numSamples, output);
+            return;
+        }
+
+        switch (numActive)
+        {
+            case 1:  processStages<1>(input, output, numSamples); break;
+            case 2:  processStages<2>(input, output, numSamples); break;
+            case 3:  processStages<3>(input, output, numSamples); break;
+            case 4:  processStages<4>(input, output, numSamples); break;
+            case 5:  processStages<5>(input, output, numSamples); break;
+            case 6:  processStages<6>(input, output, numSamples); break;
+            case 7:  processStages<7>(input, output, numSamples); break;
+            default: processStages<8>(input, output, numSamples); break;
+        }
+    }
+
+private:
+    static_assert(maxCutSections == 8, "process() needs a kernel for every stage count");
+
+    // Transposed direct form II, as IIR::Filter runs it, on the first NumStages entries of `active`
+    template<int NumStages>
+    void processStages(const float *input, float *output, int numSamples) noexcept
+    {
+        float b0[NumStages], b1[NumStages], b2[NumStages], a1[NumStages], a2[NumStages], s1[NumStages], s2[NumStages];
+
+        for (int k = 0; k < NumStages; ++k)
+        {
+            auto stage = active[k];
+            jassert(stages[stage].coefficients != nullptr && stages[stage].coefficients->getFilterOrder() == 2);
+
+            const auto *c = stages[stage].coefficients->getRawCoefficients();
+            b0[k] = c[0]; b1[k] = c[1]; b2[k] = c[2]; a1[k] = c[3]; a2[k] = c[4];
+            s1[k] = state[stage][0]; s2[k] = state[stage][1];
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto sample = input[i];
+
+            for (int k = 0; k < NumStages; ++k)
+            {
+                auto stageOutput = b0[k] * sample + s1[k];
+                s1[k] = b1[k] * sample - a1[k] * stageOutput + s2[k];
+                s2[k] = b2[k] * sample - a2[k] * stageOutput;
+                sample = stageOutput;
+            }
+
+            output[i] = sample;
+        }
+
+        for (int k = 0; k < NumStages; ++k)
+        {
+            state[active[k]][0] = juce::dsp::util::snapToZero(s1[k]);
+            state[active[k]][1] = juce::dsp::util::snapToZero(s2[k]);
+        }
+    }
+
+    Filter stages[maxCutSections];
+    bool bypassed[maxCutSections];
+    float state[maxCutSections][2] {};
+    int active[maxCutSections] {}; // the stages not bypassed, in order
+    int numActive = 0;
+};
+
+using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter, Filter>; // Represents the layout of our EQ where we have a cut on either end and a parametric filter in the middle
+
+enum ChainPositions
+{
+    LowCut, Peak, HighCut, Mid
+};
+
+using Coefficients = Filter::CoefficientsPtr;
+void updateCoefficients(Coefficients &old, const Coefficients& replacements);
+
+Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate);
+Coefficients makeMidFilter(const ChainSettings &chainSettings, double sampleRate);
+
+// Loads the first getNumCutSections(slope) designed stages and bypasses the rest
+template<typename CoefficientType>
+void updateCutFilter(CutFilter &cut, const CoefficientType &coefficients, const Slope &slope)
+{
+    auto numSections = getNumCutSections(slope);
+    for (int stage = 0; stage < maxCutSections; ++stage)
+    {
+        if (stage < numSections)
+            updateCoefficients(cut.getStage(stage).coefficients, coefficients[stage]);
+
+        cut.setStageBypassed(stage, stage >= numSections);
+    }
+}
+
+void updateChain(MonoChain &chain, const ChainSettings &chainSettings, double sampleRate); // designs and loads every band of one chain
+
+inline auto makeLowCutFilter(const ChainSettings &chainSettings, double sampleRate)
+{
+    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq, sampleRate, 2*(chainSettings.lowCutSlope+1));
+}
+
+inline auto makeHighCutFilter(const ChainSettings &chainSettings, double sampleRate)
+{
+    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq, sampleRate, 2*(chainSettings.highCutSlope+1));
+}
@@ -0,0 +1,258 @@
+#include "FixedPointChain.h"
+#include "ChainOptimiser.h"
+
+namespace
+{
+    inline juce::int32 saturate(juce::int64 value) noexcept
+    {
+        return (juce::int32) juce::jlimit((juce::int64) std::numeric_limits<juce::int32>::min(), (juce::int64) std::numeric_limits<juce::int32>::max(), value);
+    }
+}
+
+void FixedPointChain::prepare(int newHeadroomBits, NoiseShaping newNoiseShaping)
+{
+    headroomBits = juce::jlimit(0, 16, newHeadroomBits);
+    noiseShaping = newNoiseShaping;
+    reset();
+}
+
+void FixedPointChain::reset()
+{
+    for (auto &section : sections)
+    {
+        section.x1 = section.x2 = section.y1 = section.y2 = 0;
+        section.e1 = section.e2 = 0;
+    }
+}
+
+bool FixedPointChain::quantise(const BiquadCoefficients &c, Section &section)
+{
+    // Smallest shift that keeps the sum of the coefficient magnitudes at or below 1: with |x|, |y| < 2^31 that bounds
+    // the accumulator by 2^62 before noise shaping adds its (much smaller) error terms
+    auto numeratorSum = std::abs(c.b0) + std::abs(c.b1) + std::abs(c.b2);
+    auto sum = numeratorSum + std::abs(c.a1) + std::abs(c.a2);
+    auto shift = 0;
+    while (shift < 30 && sum > double(1 << shift))
+        ++shift;
+
+    // A low pass far below Nyquist has a tiny numerator (b0 ~ 4e-5 for 100 Hz at 48 kHz), which on the denominator's
+    // scale would keep only a dozen significant bits and put the pass band gain off by 0.01 dB per section. So the
+    // numerator gets its own extra scale, as far up as its products can go without exceeding the same bound, and its
+    // sum is shifted back down before the feedback terms are added.
+    auto numeratorShift = 0;
+    while (numeratorShift < 24 && numeratorSum * 2.0 <= std::ldexp(1.0, shift - numeratorShift))
+        ++numeratorShift;
+
+    auto scale = std::ldexp(1.0, 31 - shift);
+    auto numeratorScale = std::ldexp(scale, numeratorShift);
+    auto toFixed = [](double value, double toScale) { return saturate(std::llround(value * toScale)); };
+
+    section.shift = shift;
+    section.numeratorShift = numeratorShift;
+    section.b0 = toFixed(c.b0, numeratorScale);
+    section.b1 = toFixed(c.b1, numeratorScale);
+    section.b2 = toFixed(c.b2, numeratorScale);
+    section.a1 = toFixed(c.a1, scale);
+    section.a2 = toFixed(c.a2, scale);
+
+    // The cut sections' zeros sit exactly on DC (high pass, 1 -2 1) or Nyquist (low pass, 1 2 1). Rounding the three
+    // coefficients separately would move them off it and, divided by a denominator that is nearly zero there too,
+    // leak DC through a 20 Hz high pass at -60 dB, so derive b1 and b2 from b0 to keep the zeros exact
+    if (c.b2 == c.b0 && std::abs(c.b1) == 2.0 * c.b0)
+    {
+        section.b2 = section.b0;
+        section.b1 = c.b1 < 0 ? -2 * section.b0 : 2 * section.b0;
+    }
+
+    // Stability triangle on the quantised values: |a2| < 1 and |a1| < 1 + a2. Rounding can only push poles that
+    // were already within an LSB or so of the unit circle out of it, so pulling a2 in by single LSBs is enough.
+    const auto one = (juce::int64) 1 << (31 - shift);
+    auto isStable = [&section, one]
+    {
+        return std::abs((juce::int64) section.a2) < one && std::abs((juce::int64) section.a1) < one + section.a2;
+    };
+
+    if (isStable())
+        return true;
+
+    for (int attempt = 0; attempt < 64 && !isStable(); ++attempt)
+    {
+        section.a2 += section.a2 > 0 ? -1 : 1;
+        if (std::abs((juce::int64) section.a1) >= one + section.a2)
+            section.a1 += section.a1 > 0 ? -1 : 1;
+    }
+
+    jassert(isStable());
+    return false;
+}
+
+bool FixedPointChain::setSections(const BiquadCoefficients *newSections, int count)
+{
+    auto stable = true;
+    numSections = 0;
+
+    for (int k = 0; k < count; ++k)
+    {
+        if (isFlat(newSections[k]))
+            continue;
+
+        auto &section = sections[numSections++];
+        stable = quantise(newSections[k], section) && stable;
+    }
+
+    return stable;
+}
+
+bool FixedPointChain::setChainSettings(const ChainSettings &chainSettings, double sampleRate)
+{
+    BiquadCoefficients chain[maxChainSections];
+    ChainPlan plan;
+    planChain(chain, makeChainBiquads(chainSettings, sampleRate, chain), plan);
+
+    // Integer rounding is where the order matters most, so the plan's, most resonant first
+    for (int k = 0; k < plan.numUsed; ++k)
+        chain[k] = plan.sections[plan.order[k]];
+
+    return setSections(chain, plan.numUsed);
+}
+
+template<FixedPointChain::NoiseShaping shaping>
+void FixedPointChain::processSection(Section &section, juce::int32 *samples, int numSamples) noexcept
+{
+    const auto outputShift = 31 - section.shift;
+    const auto numeratorShift = section.numeratorShift;
+    const auto rounding = shaping == NoiseShaping::none ? (juce::int64) 1 << (outputShift - 1) : 0;
+    const auto b0 = (juce::int64) section.b0, b1 = (juce::int64) section.b1, b2 = (juce::int64) section.b2;
+    const auto a1 = (juce::int64) section.a1, a2 = (juce::int64) section.a2;
+
+    auto x1 = (juce::int64) section.x1, x2 = (juce::int64) section.x2;
+    auto y1 = (juce::int64) section.y1, y2 = (juce::int64) section.y2;
+    auto e1 = section.e1, e2 = section.e2;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto x0 = (juce::int64) samples[i];
+        auto accumulator = ((b0 * x0 + b1 * x1 + b2 * x2) >> numeratorShift) - a1 * y1 - a2 * y2;
+
+        // Without error feedback, round rather than truncate: the poles near DC would turn truncation's constant
+        // half-LSB bias into an offset thousands of LSBs large
+        if (shaping == NoiseShaping::none)
+            accumulator += rounding;
+        else if (shaping == NoiseShaping::firstOrder)
+            accumulator += e1;
+        else if (shaping == NoiseShaping::secondOrder)
+            accumulator += 2 * e1 - e2;
+
+        auto y0 = accumulator >> outputShift; // arithmetic shift: rounds towards -infinity, the error is always >= 0
+        e2 = e1;
+        e1 = accumulator - (y0 << outputShift);
+
+        y0 = saturate(y0);
+        samples[i] = (juce::int32) y0;
+
+        x2 = x1;
+        x1 = x0;
+        y2 = y1;
+        y1 = y0;
+    }
+
+    section.x1 = (juce::int32) x1;
+    section.x2 = (juce::int32) x2;
+    section.y1 = (juce::int32) y1;
+    section.y2 = (juce::int32) y2;
+    section.e1 = e1;
+    section.e2 = e2;
+}
+
+void FixedPointChain::process(juce::int32 *samples, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+        samples[i] >>= headroomBits;
+
+    for (int k = 0; k < numSections; ++k)
+    {
+        switch (noiseShaping)
+        {
+            case NoiseShaping::none:        processSection<NoiseShaping::none>(sections[k], samples, numSamples); break;
+            case NoiseShaping::firstOrder:  processSection<NoiseShaping::firstOrder>(sections[k], samples, numSamples); break;
+            case NoiseShaping::secondOrder: processSection<NoiseShaping::secondOrder>(sections[k], samples, numSamples); break;
+        }
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+        samples[i] = saturate((juce::int64) samples[i] << headroomBits);
+}
+
+void FixedPointChain::process(float *samples, int numSamples) noexcept
+{
+    constexpr auto fullScale = 2147483648.0;
+    auto chunkSize = (int) scratch.size();
+    jassert(chunkSize > 0);
+    if (chunkSize == 0)
+        return;
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        auto length = juce::jmin(chunkSize, numSamples - start);
+        auto *block = samples + start;
+
+        for (int i = 0; i < length; ++i)
+            scratch[(size_t) i] = saturate(std::llround((double) block[i] * fullScale));
+
+        process(scratch.data(), length);
+
+        for (int i = 0; i < length; ++i)
+            block[i] = (float) (scratch[(size_t) i] / fullScale);
+    }
+}
+
+FixedPointChain::ValidationResult FixedPointChain::validate(const ChainSettings &chainSettings, double sampleRate, NoiseShaping noiseShaping, int numSamples, double tolerance)
+{
+    MonoChain reference;
+    reference.prepare({ sampleRate, (juce::uint32) numSamples, 1 });
+    updateChain(reference, chainSettings, sampleRate);
+
+    FixedPointChain engine;
+    engine.prepare(4, noiseShaping);
+
+    ValidationResult result;
+    result.stable = engine.setChainSettings(chainSettings, sampleRate);
+
+    // Quiet enough that no boost in the parameter range clips the fixed point path
+    juce::AudioBuffer<float> expected(1, numSamples), actual(1, numSamples);
+    juce::Random random(1234);
+    for (int i = 0; i < numSamples; ++i)
+        expected.setSample(0, i, (random.nextFloat() * 2.f - 1.f) * 0.03f);
+    actual.copyFrom(0, 0, expected, 0, 0, numSamples);
+
+    // Both are measured against the same sections in double precision, so the fixed point error can be put next to
+    // what MonoChain's own float rounding does with the same settings
+    std::vector<double> exact(expected.getReadPointer(0), expected.getReadPointer(0) + numSamples);
+    BiquadCoefficients chain[maxChainSections];
+    auto numSections = makeChainBiquads(chainSettings, sampleRate, chain);
+
+    for (int k = 0; k < numSections; ++k)
+    {
+        double s1 = 0, s2 = 0;
+        processBiquad(chain[k], s1, s2, exact.data(), numSamples);
+    }
+
+    juce::dsp::AudioBlock<float> block(expected);
+    juce::dsp::ProcessContextReplacing<float> context(block);
+    reference.process(context);
+
+    for (int start = 0; start < numSamples; start += 509)
+        engine.process(actual.getWritePointer(0) + start, juce::jmin(509, numSamples - start));
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto exactSample = exact[(size_t) i];
+        result.maxError = juce::jmax(result.maxError, std::abs(exactSample - (double) actual.getSample(0, i)));
+        result.referenceError = juce::jmax(result.referenceError, std::abs(exactSample - (double) expected.getSample(0, i)));
+        result.referencePeak = juce::jmax(result.referencePeak, std::abs(exactSample));
+    }
+
+    result.errorDecibels = juce::Decibels::gainToDecibels(result.maxError / juce::jmax(1.0e-12, result.referencePeak), -200.0);
+    result.passed = result.maxError <= juce::jmax(result.referenceError, tolerance * result.referencePeak);
+    return result;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "BiquadDesign.h"
+
+//==============================================================================
+/**
+    MonoChain's sections (Butterworth cuts, Peak, Mid) in integer arithmetic, for targets without an FPU.
+
+    Each section is a direct form I biquad with Q1.31 coefficients and a 64-bit accumulator. Coefficients whose
+    magnitudes add up to more than 1 are stored scaled down by a per-section power of two (the section's shift),
+    which keeps every accumulator sum inside 64 bits without ever saturating it. The truncation error of each
+    output can be fed back into the next accumulation (error feedback noise shaping), which matters most for the
+    low cut and low peaks, whose poles sit right next to z = 1 and amplify plain truncation noise.
+
+    Only processing is integer: setChainSettings() designs in double and quantises, so on an FPU-less target
+    coefficients are designed on the host (or with soft float, it's off the audio path) and loaded from there.
+    The float process() is for running and testing the engine on a desktop against the float chain.
+*/
+class FixedPointChain
+{
+public:
+    enum class NoiseShaping
+    {
+        none, firstOrder, secondOrder
+    };
+
+    // headroomBits: the input is scaled down by this many bits on the way in (and back up on the way out) so boosts
+    // and cut resonances have room before the Q1.31 range clips. 4 bits = 24 dB, the Peak/Mid gain range.
+    void prepare(int headroomBits = 4, NoiseShaping noiseShaping = NoiseShaping::firstOrder);
+    void reset();
+
+    // Quantises the sections planChain() keeps of what MonoChain would run, in the plan's order. Returns false if a section
+    // came out unstable after quantisation and had to have its poles pulled in (only possible for poles within a few
+    // LSBs of the unit circle).
+    bool setChainSettings(const ChainSettings &chainSettings, double sampleRate);
+    bool setSections(const BiquadCoefficients *newSections, int numSections);
+
+    void process(juce::int32 *samples, int numSamples) noexcept; // Q1.31 in and out
+    void process(float *samples, int numSamples) noexcept;       // converts, saturating at +-1
+
+    struct ValidationResult
+    {
+        double maxError = 0;       // largest absolute difference from the chain run in double precision
+        double referenceError = 0; // the same for MonoChain, i.e. what float rounding costs with these settings
+        double referencePeak = 0;  // largest absolute output, for scale
+        double errorDecibels = 0;  // maxError relative to referencePeak
+        bool stable = false;       // setChainSettings() didn't have to adjust any poles
+        bool passed = false;
+    };
+
+    // Filters the same noise through this engine, a MonoChain and the double precision cascade. Passes when the fixed
+    // point error is no worse than MonoChain's, or below tolerance x the output peak (-80 dB by default).
+    static ValidationResult validate(const ChainSettings &chainSettings, double sampleRate, NoiseShaping noiseShaping = NoiseShaping::firstOrder,
+                                     int numSamples = 1 << 16, double tolerance = 1.0e-4);
+
+private:
+    struct Section
+    {
+        juce::int32 b0 = 0, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+        int shift = 0;          // coefficients are Q1.31 x 2^-shift
+        int numeratorShift = 0; // b0..b2 are additionally x 2^numeratorShift
+        juce::int32 x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+        juce::int64 e1 = 0, e2 = 0; // the last two truncation errors, for noise shaping
+    };
+
+    static bool quantise(const BiquadCoefficients &coefficients, Section &section);
+
+    template<NoiseShaping shaping>
+    static void processSection(Section &section, juce::int32 *samples, int numSamples) noexcept;
+
+    Section sections[maxChainSections];
+    int numSections = 0, headroomBits = 4;
+    NoiseShaping noiseShaping = NoiseShaping::firstOrder;
+    std::vector<juce::int32> scratch = std::vector<juce::int32>(1024); // float process() converts in chunks this size
+};
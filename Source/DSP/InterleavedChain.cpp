@@ -0,0 +1,77 @@
+#include "InterleavedChain.h"
+#include "ChainOptimiser.h"
+
+void InterleavedChain::prepare(double newSampleRate, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    numChannels = newNumChannels;
+    state.assign((size_t) (maxChainSections * 2 * numChannels), 0.f);
+}
+
+void InterleavedChain::reset()
+{
+    std::fill(state.begin(), state.end(), 0.f);
+}
+
+void InterleavedChain::setSection(int slot, const BiquadCoefficients &coefficients, bool used)
+{
+    auto &section = sections[slot];
+    auto wasActive = section.active;
+
+    section.b0 = (float) coefficients.b0;
+    section.b1 = (float) coefficients.b1;
+    section.b2 = (float) coefficients.b2;
+    section.a1 = (float) coefficients.a1;
+    section.a2 = (float) coefficients.a2;
+    section.active = used;
+
+    // Like a bypassed IIR::Filter being re-enabled, except that here a section resumes from silence rather than stale state
+    if (section.active && !wasActive)
+    {
+        auto *slotState = state.data() + slot * 2 * numChannels;
+        std::fill(slotState, slotState + 2 * numChannels, 0.f);
+    }
+}
+
+void InterleavedChain::setSettings(const ChainSettings &chainSettings)
+{
+    BiquadCoefficients designed[maxChainSections];
+    ChainPlan plan;
+    planChain(designed, makeChainBiquads(chainSettings, sampleRate, designed), plan);
+
+    // Sections keep their slots, and with them their state; the plan only decides which run and what a merged pair runs
+    auto numLowCut = getNumCutSections(chainSettings.lowCutSlope);
+    auto numHighCut = getNumCutSections(chainSettings.highCutSlope);
+    auto setFromPlan = [this, &plan](int slot, int index, bool inChain)
+    {
+        setSection(slot, inChain ? plan.sections[index] : BiquadCoefficients(), inChain && plan.used[index]);
+    };
+
+    for (int i = 0; i < maxCutSections; ++i)
+        setFromPlan(i, i, i < numLowCut);
+
+    setFromPlan(peakSlot, numLowCut, true);
+
+    for (int i = 0; i < maxCutSections; ++i)
+        setFromPlan(highCutSlot + i, numLowCut + 1 + i, i < numHighCut);
+
+    setFromPlan(midSlot, numLowCut + 1 + numHighCut, true);
+}
+
+void InterleavedChain::process(float *interleaved, int numFrames) noexcept
+{
+    for (int slot = 0; slot < maxChainSections; ++slot)
+    {
+        const auto &section = sections[slot];
+        if (!section.active)
+            continue;
+
+        auto *s1 = state.data() + slot * 2 * numChannels;
+        auto *s2 = s1 + numChannels;
+        auto *frame = interleaved;
+
+        for (int i = 0; i < numFrames; ++i, frame += numChannels)
+            for (int channel = 0; channel < numChannels; ++channel)
+                frame[channel] = processBiquadSample(frame[channel], section.b0, section.b1, section.b2, section.a1, section.a2, s1[channel], s2[channel]);
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "BiquadDesign.h"
+
+//==============================================================================
+/**
+    The FiltEQ chain for any number of channels that share settings, run directly on interleaved frames.
+
+    For streaming raw PCM there's no point splitting the input into an AudioBuffer and back: each section here
+    walks the interleaved buffer once with one state pair per channel, so the channel loop is the inner one.
+    Sections are kept in MonoChain slot order, and unused ones and those planChain() drops or merges are skipped.
+*/
+class InterleavedChain
+{
+public:
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    // Redesigns the sections. Filter state is kept, as when the plugin's parameters move, so this can be called between
+    // any two blocks without a gap or a reset in the output.
+    void setSettings(const ChainSettings &chainSettings);
+
+    void process(float *interleaved, int numFrames) noexcept;
+
+    // A one-channel chain run like a MonoChain, so ChainTransition can prewarm it and crossfade to or from it
+    template<typename ProcessContext>
+    void process(const ProcessContext &context) noexcept
+    {
+        const auto &inputBlock = context.getInputBlock();
+        auto &outputBlock = context.getOutputBlock();
+        jassert(numChannels == 1 && inputBlock.getNumChannels() == 1 && outputBlock.getNumChannels() == 1);
+
+        auto numSamples = (int) outputBlock.getNumSamples();
+        if (inputBlock.getChannelPointer(0) != outputBlock.getChannelPointer(0))
+            std::copy(inputBlock.getChannelPointer(0), inputBlock.getChannelPointer(0) + numSamples, outputBlock.getChannelPointer(0));
+
+        if (!context.isBypassed)
+            process(outputBlock.getChannelPointer(0), numSamples);
+    }
+
+    // The filter state as a flat array of getStateSize() floats, for saving and restoring (see RenderCache)
+    int getStateSize() const noexcept { return (int) state.size(); }
+    void getState(float *destination) const noexcept { std::copy(state.begin(), state.end(), destination); }
+    void setState(const float *source) noexcept { std::copy(source, source + state.size(), state.begin()); }
+
+private:
+    static constexpr int peakSlot = maxCutSections;
+    static constexpr int highCutSlot = maxCutSections + 1;
+    static constexpr int midSlot = 2 * maxCutSections + 1;
+
+    struct Section
+    {
+        float b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+        bool active = false;
+    };
+
+    void setSection(int slot, const BiquadCoefficients &coefficients, bool used);
+
+    Section sections[maxChainSections];
+    std::vector<float> state; // s1 then s2 for every channel, per slot
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+};
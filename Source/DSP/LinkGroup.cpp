@@ -0,0 +1,122 @@
+#include "LinkGroup.h"
+
+namespace
+{
+    const char* const parameterIds[LinkGroup::numParameters] =
+    {
+        "Low Cut Freq", "Low Cut Slope", "High Cut Freq", "High Cut Slope",
+        "Peak Frequency", "Peak Gain", "Peak Quality",
+        "Mid Frequency", "Mid Gain", "Mid Quality",
+        "Low Cut Steep", "High Cut Steep"
+    };
+
+    int findParameter(juce::StringRef id) noexcept
+    {
+        for (int i = 0; i < LinkGroup::numParameters; ++i)
+            if (id == juce::StringRef(parameterIds[i]))
+                return i;
+        return -1;
+    }
+}
+
+LinkGroup::LinkGroup()
+{
+    // Start on the parameter defaults, so a design made before the first member seeds the group is still a sensible one
+    ChainSettings defaults;
+    const float initial[numParameters] = { defaults.lowCutFreq, (float) (defaults.lowCutSlope % numSlopeChoices),
+                                           defaults.highCutFreq, (float) (defaults.highCutSlope % numSlopeChoices),
+                                           defaults.peakFreq, defaults.peakGainInDecibels, defaults.peakQuality,
+                                           defaults.midFreq, defaults.midGainInDecibels, defaults.midQuality,
+                                           defaults.lowCutSlope >= numSlopeChoices ? 1.f : 0.f, defaults.highCutSlope >= numSlopeChoices ? 1.f : 0.f };
+    for (int i = 0; i < numParameters; ++i)
+        values[i].store(initial[i], std::memory_order_relaxed);
+}
+
+LinkGroup& LinkGroup::get(int index)
+{
+    jassert(index >= 0 && index < numGroups);
+
+    static LinkGroup groups[numGroups];
+    return groups[index];
+}
+
+const char* LinkGroup::getParameterId(int index) noexcept
+{
+    return parameterIds[index];
+}
+
+void LinkGroup::setParameter(juce::StringRef id, float value) noexcept
+{
+    auto index = findParameter(id);
+    if (index < 0)
+        return;
+
+    values[index].store(value, std::memory_order_relaxed);
+    version.fetch_add(1, std::memory_order_release);
+}
+
+std::atomic<float>* LinkGroup::getRawParameterValue(juce::StringRef id) noexcept
+{
+    auto index = findParameter(id);
+    jassert(index >= 0);
+    return &values[juce::jmax(0, index)];
+}
+
+bool LinkGroup::getSnapshot(double sampleRate, Snapshot &destination) noexcept
+{
+    auto currentVersion = version.load(std::memory_order_acquire);
+
+    if (designedVersion.load(std::memory_order_acquire) != currentVersion
+        || designedSampleRate.load(std::memory_order_acquire) != sampleRate)
+    {
+        // Whoever gets here first designs; anyone arriving meanwhile copies the previous design for one more block
+        auto expected = false;
+        if (designing.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        {
+            if (designedVersion.load(std::memory_order_relaxed) != currentVersion
+                || designedSampleRate.load(std::memory_order_relaxed) != sampleRate)
+                design(currentVersion, sampleRate);
+
+            designing.store(false, std::memory_order_release);
+        }
+    }
+
+    auto before = sequence.load(std::memory_order_acquire);
+    if ((before & 1) != 0)
+        return false;
+
+    juce::uint64 copy[numWords];
+    for (size_t i = 0; i < numWords; ++i)
+        copy[i] = words[i].load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence.load(std::memory_order_relaxed) != before)
+        return false;
+
+    std::memcpy(&destination, copy, sizeof(Snapshot));
+    return destination.sampleRate == sampleRate;
+}
+
+void LinkGroup::design(juce::uint32 designVersion, double sampleRate) noexcept
+{
+    // The version is read before the values, so an edit landing in between only causes one more design next block
+    Snapshot snapshot;
+    snapshot.settings = getChainSettings(*this);
+    snapshot.sampleRate = sampleRate;
+    makeChainBiquads(snapshot.settings, sampleRate, snapshot.sections);
+
+    juce::uint64 copy[numWords] {};
+    std::memcpy(copy, &snapshot, sizeof(Snapshot));
+
+    auto current = sequence.load(std::memory_order_relaxed);
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < numWords; ++i)
+        words[i].store(copy[i], std::memory_order_relaxed);
+
+    sequence.store(current + 2, std::memory_order_release);
+
+    designedSampleRate.store(sampleRate, std::memory_order_release);
+    designedVersion.store(designVersion, std::memory_order_release);
+}
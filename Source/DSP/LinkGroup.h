@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoefficientTable.h"
+
+//==============================================================================
+/**
+    One parameter set and one coefficient design shared by every instance in the process that joins the group.
+
+    The group holds the EQ parameters as atomics, so getChainSettings() reads it the same way it reads an
+    AudioProcessorValueTreeState, and a version that every setParameter() bumps. The first member's audio
+    thread to see a new version designs the whole chain once and publishes it; every member then copies that
+    snapshot and only loads it into its chains. Publication is a sequence lock over relaxed atomic words: the
+    single designer (picked with a compare-exchange) never waits, and a reader that overlaps a write just gets
+    false back and designs on its own for that block.
+
+    Groups live for the whole process (there are numGroups of them), so the audio thread can hold a plain
+    pointer to one while the message thread joins and leaves.
+*/
+class LinkGroup
+{
+public:
+    static constexpr int numGroups = 8;
+    static constexpr int numParameters = 12;
+
+    static LinkGroup& get(int index); // 0 to numGroups - 1
+
+    // The parameter IDs a group shares, the ones getChainSettings() reads
+    static const char* getParameterId(int index) noexcept;
+
+    // Message thread. join() returns true for the first member, which should then seed the group with its own values.
+    bool join() noexcept { return members.fetch_add(1) == 0; }
+    void leave() noexcept { members.fetch_sub(1); }
+
+    // Any thread, including the audio thread for host automation. Unknown IDs are ignored.
+    void setParameter(juce::StringRef id, float value) noexcept;
+    std::atomic<float>* getRawParameterValue(juce::StringRef id) noexcept;
+    float getParameter(int index) const noexcept { return values[index].load(std::memory_order_relaxed); }
+    juce::uint32 getVersion() const noexcept { return version.load(std::memory_order_acquire); }
+
+    struct Snapshot
+    {
+        ChainSettings settings;
+        double sampleRate = 0;
+        BiquadCoefficients sections[maxChainSections]; // in makeChainBiquads order
+    };
+
+    // Audio thread: designs the current parameters if nobody has yet, then copies the shared design. Returns false
+    // if there's no design at this sample rate to copy right now, in which case the caller designs its own.
+    bool getSnapshot(double sampleRate, Snapshot &destination) noexcept;
+
+private:
+    LinkGroup();
+
+    void design(juce::uint32 designVersion, double sampleRate) noexcept;
+
+    static constexpr size_t numWords = (sizeof(Snapshot) + sizeof(juce::uint64) - 1) / sizeof(juce::uint64);
+
+    std::atomic<int> members {0};
+    std::atomic<float> values[numParameters];
+    std::atomic<juce::uint32> version {1};
+
+    std::atomic<bool> designing {false};
+    std::atomic<juce::uint32> designedVersion {0}; // 0 until the first design
+    std::atomic<double> designedSampleRate {0};
+    std::atomic<juce::uint32> sequence {0}; // odd while a design is being written
+    std::atomic<juce::uint64> words[numWords] {};
+
+    JUCE_DECLARE_NON_COPYABLE (LinkGroup)
+};
@@ -0,0 +1,90 @@
+#include "MidSideChain.h"
+
+void planMidSide(const ChainSettings &chainSettings, const BiquadCoefficients *sections, const MidSideRouting &routing, MidSidePlan &plan) noexcept
+{
+    auto numLowCut = getNumCutSections(chainSettings.lowCutSlope);
+    auto numSections = numLowCut + getNumCutSections(chainSettings.highCutSlope) + 2;
+    auto peakIndex = numLowCut, midIndex = numSections - 1;
+
+    plan.routing = routing;
+
+    for (int path = 0; path < MidSidePlan::numPaths; ++path)
+    {
+        auto other = path == MidSidePlan::midPath ? MidSidePath::side : MidSidePath::mid;
+
+        // A band that isn't on this path is identity here, which the planner drops at no cost to its budget
+        BiquadCoefficients pathSections[maxChainSections];
+        std::copy(sections, sections + numSections, pathSections);
+
+        if (routing.lowCut == other)
+            std::fill(pathSections, pathSections + numLowCut, BiquadCoefficients());
+        if (routing.peak == other)
+            pathSections[peakIndex] = {};
+        if (routing.mid == other)
+            pathSections[midIndex] = {};
+
+        planChain(pathSections, numSections, plan.paths[path]);
+    }
+}
+
+//==============================================================================
+void MidSideChain::reset() noexcept
+{
+    for (auto &section : sections)
+    {
+        std::fill(std::begin(section.s1), std::end(section.s1), 0.f);
+        std::fill(std::begin(section.s2), std::end(section.s2), 0.f);
+    }
+}
+
+void MidSideChain::setPlan(const MidSidePlan &plan) noexcept
+{
+    numActiveSlots = 0;
+
+    for (int slot = 0; slot < maxChainSections; ++slot)
+    {
+        auto &section = sections[slot];
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const auto &path = plan.paths[lane];
+            auto used = slot < path.numSections && path.used[slot];
+            auto c = used ? path.sections[slot] : BiquadCoefficients();
+
+            section.b0[lane] = (float) c.b0;
+            section.b1[lane] = (float) c.b1;
+            section.b2[lane] = (float) c.b2;
+            section.a1[lane] = (float) c.a1;
+            section.a2[lane] = (float) c.a2;
+
+            // An identity lane only stays exact while its state is zero, and a lane taking a section up starts clean
+            if (used != section.used[lane])
+                section.s1[lane] = section.s2[lane] = 0.f;
+
+            section.used[lane] = used;
+        }
+
+        if (section.used[MidSidePlan::midPath] || section.used[MidSidePlan::sidePath])
+            activeSlots[numActiveSlots++] = slot;
+    }
+}
+
+void MidSideChain::process(float *left, float *right, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float x[numLanes] = { 0.5f * (left[i] + right[i]), 0.5f * (left[i] - right[i]) };
+
+        for (int k = 0; k < numActiveSlots; ++k) // both lanes at once
+        {
+            auto &section = sections[activeSlots[k]];
+
+            for (int lane = 0; lane < numLanes; ++lane)
+                x[lane] = processBiquadSample(x[lane], section.b0[lane], section.b1[lane], section.b2[lane], section.a1[lane], section.a2[lane],
+                                              section.s1[lane], section.s2[lane]);
+        }
+
+        left[i] = x[0] + x[1];
+        right[i] = x[0] - x[1];
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ChainOptimiser.h"
+
+enum class MidSidePath
+{
+    both, mid, side
+};
+
+struct MidSideRouting // which path each band filters; the high cut always filters both
+{
+    MidSidePath lowCut = MidSidePath::both, peak = MidSidePath::both, mid = MidSidePath::both;
+};
+
+inline bool operator== (const MidSideRouting &a, const MidSideRouting &b)
+{
+    return a.lowCut == b.lowCut && a.peak == b.peak && a.mid == b.mid;
+}
+
+inline bool operator!= (const MidSideRouting &a, const MidSideRouting &b) { return !(a == b); }
+
+// The chain as each path runs it: the design with the bands routed away from that path taken out, then planned
+struct MidSidePlan
+{
+    enum { midPath, sidePath, numPaths };
+
+    ChainPlan paths[numPaths];
+    MidSideRouting routing;
+
+    // True when a MidSideChain running one can switch to the other in place: each path merges the same pairs and
+    // no band has moved to another path (its state would stand for the other path's signal)
+    bool canSwitchInPlace(const MidSidePlan &other) const noexcept
+    {
+        return routing == other.routing && paths[midPath].hasSameMerges(other.paths[midPath]) && paths[sidePath].hasSameMerges(other.paths[sidePath]);
+    }
+};
+
+// Plans both paths of a cascade laid out the way makeChainBiquads writes it for chainSettings
+void planMidSide(const ChainSettings &chainSettings, const BiquadCoefficients *sections, const MidSideRouting &routing, MidSidePlan &plan) noexcept;
+
+//==============================================================================
+/**
+    The FiltEQ chain run on the mid and side of a stereo signal instead of on left and right.
+
+    Encoding, both paths' cascades and decoding are one loop over the block: each sample is encoded, taken through
+    every section with mid and side side by side in two adjacent lanes, and decoded before the next, so there's no
+    extra pass over the buffer and the two paths cost about what left and right do in a pair of MonoChains. A band on
+    one path only is identity in the other lane of its section; a section neither path uses isn't run at all.
+
+    Sections keep their MonoChain slots (and their state) as the plan changes, and a lane that starts or stops using
+    a section has its state cleared, so it resumes from silence rather than from what another band left there.
+*/
+class MidSideChain
+{
+public:
+    void reset() noexcept;
+
+    // Doesn't allocate, so this can be called between any two blocks
+    void setPlan(const MidSidePlan &plan) noexcept;
+
+    // Left and right in, left and right out, in place
+    void process(float *left, float *right, int numSamples) noexcept;
+
+private:
+    static constexpr int numLanes = MidSidePlan::numPaths;
+
+    struct Section
+    {
+        float b0[numLanes] {1, 1}, b1[numLanes] {}, b2[numLanes] {}, a1[numLanes] {}, a2[numLanes] {};
+        float s1[numLanes] {}, s2[numLanes] {};
+        bool used[numLanes] {};
+    };
+
+    Section sections[maxChainSections];
+    int activeSlots[maxChainSections] {}; // sections at least one lane uses, in slot order
+    int numActiveSlots = 0;
+};
@@ -0,0 +1,188 @@
+#include "ModulatedBand.h"
+
+void TptSvf::setMode(Mode mode, double quality, double gainFactor) noexcept
+{
+    switch (mode)
+    {
+        case bell:
+        {
+            // Same prototype makePeakFilter prewarps: (s^2 + s A/Q + 1) / (s^2 + s/(A Q) + 1)
+            auto A = std::sqrt(juce::jmax(1.0e-6, gainFactor));
+            k = 1.0 / (quality * A);
+            m0 = 1.0;
+            m1 = k * (A * A - 1.0);
+            m2 = 0.0;
+            break;
+        }
+        case highPass:
+            k = 1.0 / quality;
+            m0 = 1.0;
+            m1 = -k;
+            m2 = -1.0;
+            break;
+        case lowPass:
+            k = 1.0 / quality;
+            m0 = 0.0;
+            m1 = 0.0;
+            m2 = 1.0;
+            break;
+        case allPass:
+            k = 1.0 / quality;
+            m0 = 1.0;
+            m1 = -2.0 * k;
+            m2 = 0.0;
+            break;
+    }
+}
+
+//==============================================================================
+void BandModulator::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    offsets.assign((size_t) maximumBlockSize, 0.f);
+
+    // Quick enough to open a wah on a pick attack, slow enough not to ripple with the waveform
+    attack = 1.0 - std::exp(-1.0 / (0.005 * sampleRate));
+    release = 1.0 - std::exp(-1.0 / (0.08 * sampleRate));
+
+    reset();
+}
+
+void BandModulator::reset()
+{
+    phase = 0.0;
+    level = 0.0;
+}
+
+void BandModulator::setRate(double hertz) noexcept
+{
+    phaseIncrement = juce::MathConstants<double>::twoPi * hertz / sampleRate;
+}
+
+void BandModulator::generate(const juce::dsp::AudioBlock<float> &input)
+{
+    auto numSamples = (int) input.getNumSamples();
+    jassert(numSamples <= (int) offsets.size());
+
+    if (source == lfo)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            offsets[(size_t) i] = (float) (depth * std::sin(phase));
+            phase += phaseIncrement;
+        }
+
+        phase = std::fmod(phase, juce::MathConstants<double>::twoPi);
+        return;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        double peak = 0;
+        for (size_t channel = 0; channel < input.getNumChannels(); ++channel)
+            peak = juce::jmax(peak, (double) std::abs(input.getSample((int) channel, i)));
+
+        level += (peak > level ? attack : release) * (peak - level);
+        offsets[(size_t) i] = (float) (depth * juce::jmin(1.0, level)); // full depth at 0 dBFS
+    }
+}
+
+//==============================================================================
+void BandSaturator::setDrive(float decibels) noexcept
+{
+    auto newGain = juce::Decibels::decibelsToGain((double) juce::jmax(0.f, decibels)) - 1.0;
+    if (newGain == gain)
+        return;
+
+    gain = newGain;
+    inverseGain = gain > 0.0 ? 1.0 / gain : 0.0;
+    previousIntegral = gain > 0.0 ? getDistortionIntegral(previous) : 0.0; // keep the next difference on one curve
+}
+
+//==============================================================================
+void SaturatedBand::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void SaturatedBand::setBand(float frequency, float quality, float gainInDecibels, float driveInDecibels) noexcept
+{
+    svf.setMode(TptSvf::bell, quality, juce::Decibels::decibelsToGain((double) gainInDecibels));
+    svf.setCutoff(std::tan(juce::MathConstants<double>::pi * juce::jmin((double) frequency, 0.49 * sampleRate) / sampleRate));
+    saturator.setDrive(driveInDecibels);
+}
+
+void SaturatedBand::process(float *samples, int numSamples) noexcept
+{
+    if (fade.isActive())
+    {
+        // Only what the band adds is scaled, so faded out the signal passes through untouched
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto band = svf.processBellBand(samples[i]);
+            auto added = saturator.isActive() ? saturator.process(band) : band;
+            samples[i] = (float) (samples[i] + fade.next() * added);
+        }
+        return;
+    }
+
+    if (!saturator.isActive())
+    {
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = (float) svf.processSample(samples[i]);
+        return;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+        samples[i] = (float) (samples[i] + saturator.process(svf.processBellBand(samples[i])));
+}
+
+//==============================================================================
+void ModulatedBand::prepare(double sampleRate)
+{
+    // Anything the modulation pushes outside 10 Hz ... 0.49 * sampleRate is clamped to the ends
+    minimumOctave = std::log2(10.0);
+    maximumOctave = std::log2(0.49 * sampleRate);
+    stepsPerOctave = (tableSize - 1) / (maximumOctave - minimumOctave);
+
+    cutoffTable.resize(tableSize + 1); // one spare so the lerp can always read [i + 1]
+    for (int i = 0; i < tableSize; ++i)
+        cutoffTable[(size_t) i] = std::tan(juce::MathConstants<double>::pi * std::exp2(minimumOctave + i / stepsPerOctave) / sampleRate);
+    cutoffTable[tableSize] = cutoffTable[tableSize - 1];
+
+    reset();
+}
+
+void ModulatedBand::setBand(float frequency, float quality, float gainInDecibels) noexcept
+{
+    svf.setMode(TptSvf::bell, quality, juce::Decibels::decibelsToGain((double) gainInDecibels));
+    centreOctave = std::log2(juce::jmax(10.f, frequency));
+}
+
+void ModulatedBand::process(float *samples, const float *offsets, int numSamples) noexcept
+{
+    auto lastIndex = (double) (tableSize - 1);
+    auto fading = fade.isActive(); // for the whole block, since one fading out must stay silent once it's done
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto position = juce::jlimit(0.0, lastIndex, (centreOctave + offsets[i] - minimumOctave) * stepsPerOctave);
+        auto index = (int) position;
+        auto fraction = position - index;
+        auto g = cutoffTable[(size_t) index] + fraction * (cutoffTable[(size_t) index + 1] - cutoffTable[(size_t) index]);
+
+        svf.setCutoff(g);
+
+        if (fading)
+        {
+            auto band = svf.processBellBand(samples[i]);
+            auto added = saturator.isActive() ? saturator.process(band) : band;
+            samples[i] = (float) (samples[i] + fade.next() * added);
+            continue;
+        }
+
+        samples[i] = saturator.isActive() ? (float) (samples[i] + saturator.process(svf.processBellBand(samples[i])))
+                                          : (float) svf.processSample(samples[i]);
+    }
+}
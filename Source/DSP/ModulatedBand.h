@@ -0,0 +1,241 @@
+#pragma once
+
+#include "FilterChain.h"
+
+//==============================================================================
+/**
+    A topology-preserving (trapezoidal integrator) state-variable filter, after Zavalishin and Simper.
+
+    With fixed settings each mode has exactly the transfer function of the matching IIR::Coefficients design
+    (makePeakFilter, makeHighPass, makeLowPass: all bilinear with the cutoff prewarped), so it can stand in for a
+    MonoChain section. The difference is where the state lives: in the two integrators rather than in a direct form's
+    delays, which keeps it well behaved when the cutoff changes every sample.
+*/
+class TptSvf
+{
+public:
+    enum Mode
+    {
+        bell, highPass, lowPass, allPass
+    };
+
+    void setMode(Mode mode, double quality, double gainFactor = 1.0) noexcept;
+
+    // g = tan(pi * cutoff / sampleRate). Cheap enough to call every sample.
+    void setCutoff(double g) noexcept
+    {
+        a1 = 1.0 / (1.0 + g * (g + k));
+        a2 = g * a1;
+        a3 = g * a2;
+    }
+
+    double processSample(double v0) noexcept
+    {
+        auto v3 = v0 - ic2eq;
+        auto v1 = a1 * ic1eq + a2 * v3;
+        auto v2 = ic2eq + a2 * ic1eq + a3 * v3;
+        ic1eq = 2.0 * v1 - ic1eq;
+        ic2eq = 2.0 * v2 - ic2eq;
+        return m0 * v0 + m1 * v1 + m2 * v2;
+    }
+
+    // The part a bell adds to its input, m1 v1, so that processSample(v0) == v0 + processBellBand(v0)
+    double processBellBand(double v0) noexcept
+    {
+        auto v3 = v0 - ic2eq;
+        auto v1 = a1 * ic1eq + a2 * v3;
+        auto v2 = ic2eq + a2 * ic1eq + a3 * v3;
+        ic1eq = 2.0 * v1 - ic1eq;
+        ic2eq = 2.0 * v2 - ic2eq;
+        return m1 * v1;
+    }
+
+    // Low pass and all pass (LP - k BP + HP) of one input from a single update, whatever the mode's output mix.
+    // A Linkwitz-Riley split needs both, and the all pass is what its two outputs sum to.
+    void processLowAndAllPass(double v0, double &lowPass, double &allPassOutput) noexcept
+    {
+        auto v3 = v0 - ic2eq;
+        auto v1 = a1 * ic1eq + a2 * v3;
+        auto v2 = ic2eq + a2 * ic1eq + a3 * v3;
+        ic1eq = 2.0 * v1 - ic1eq;
+        ic2eq = 2.0 * v2 - ic2eq;
+        lowPass = v2;
+        allPassOutput = v0 - 2.0 * k * v1;
+    }
+
+    void reset() noexcept { ic1eq = ic2eq = 0.0; }
+
+private:
+    double k = 1.0, m0 = 1.0, m1 = 0.0, m2 = 0.0; // damping and output mix, set by the mode
+    double a1 = 1.0, a2 = 0.0, a3 = 0.0;
+    double ic1eq = 0.0, ic2eq = 0.0;
+};
+
+//==============================================================================
+/**
+    The built-in modulation source: an LFO or an envelope follower, as an offset in octaves per sample.
+
+    One of these drives every modulated band on every channel, so the bands move together.
+*/
+class BandModulator
+{
+public:
+    enum Source
+    {
+        lfo, envelope
+    };
+
+    void prepare(double sampleRate, int maximumBlockSize);
+    void reset();
+
+    void setSource(Source newSource) noexcept { source = newSource; }
+    void setRate(double hertz) noexcept;             // LFO only
+    void setDepth(double octaves) noexcept { depth = octaves; } // negative sweeps down
+
+    // Fills getOffsets() for the next numSamples. The envelope follows the loudest of the channels.
+    void generate(const juce::dsp::AudioBlock<float> &input);
+    const float* getOffsets() const noexcept { return offsets.data(); }
+
+    int getMaximumBlockSize() const noexcept { return (int) offsets.size(); }
+
+private:
+    std::vector<float> offsets;
+    Source source = lfo;
+    double sampleRate = 44100.0, depth = 0.0;
+    double phase = 0.0, phaseIncrement = 0.0;
+    double level = 0.0, attack = 0.0, release = 0.0;
+};
+
+//==============================================================================
+/**
+    Soft saturation of a bell's added band, s(b) = tanh(g b) / g, with first-order antiderivative anti-aliasing.
+
+    Only the distortion, s(b) - b, goes through the antiderivative: (E(b[n]) - E(b[n-1])) / (b[n] - b[n-1]) with
+    E(b) = log(cosh(g b)) / g^2 - b^2 / 2. That averages the distortion over each sample interval, which is what
+    suppresses the aliasing, while the band itself passes straight through, so the half-sample delay ADAA brings
+    never touches the EQ's linear response. g comes from the drive as decibelsToGain(drive) - 1, so 0 dB is exactly
+    linear and 24 dB starts compressing the band around -24 dBFS.
+*/
+class BandSaturator
+{
+public:
+    void setDrive(float decibels) noexcept;
+    bool isActive() const noexcept { return gain > 0.0; }
+    void reset() noexcept { previous = previousIntegral = 0.0; }
+
+    double process(double band) noexcept
+    {
+        auto integral = getDistortionIntegral(band);
+        auto delta = band - previous;
+
+        // Nearly equal samples would divide rounding error by almost nothing; the midpoint's distortion is the limit
+        auto distortion = std::abs(delta) > 1.0e-5 ? (integral - previousIntegral) / delta
+                                                   : getDistortion(0.5 * (band + previous));
+        previous = band;
+        previousIntegral = integral;
+        return band + distortion;
+    }
+
+private:
+    double getDistortion(double band) const noexcept { return std::tanh(gain * band) * inverseGain - band; }
+    double getDistortionIntegral(double band) const noexcept
+    {
+        auto x = std::abs(gain * band);
+        auto logCosh = x + std::log1p(std::exp(-2.0 * x)) - ln2;
+        return logCosh * inverseGain * inverseGain - 0.5 * band * band;
+    }
+
+    static constexpr double ln2 = 0.69314718055994530942;
+
+    double gain = 0.0, inverseGain = 0.0;
+    double previous = 0.0, previousIntegral = 0.0;
+};
+
+//==============================================================================
+/**
+    Scales what a band adds to the signal while it's handed between the chains and its own processor.
+
+    The gain ramps linearly over the length of a ChainTransition fade started in the same block, sample for sample
+    with it, so the band comes in as the chains it leaves crossfade out and the other way round.
+*/
+class BandFade
+{
+public:
+    void start(bool fadeIn, int length) noexcept { in = fadeIn; fadeLength = juce::jmax(1, length); position = 0; }
+    void finish() noexcept { position = fadeLength; }
+    bool isActive() const noexcept { return position < fadeLength; }
+
+    // Gain for the next sample; once the fade is over, 1 faded in or 0 faded out
+    float next() noexcept
+    {
+        auto gain = (float) position / (float) fadeLength;
+        position = juce::jmin(position + 1, fadeLength);
+        return in ? gain : 1.f - gain;
+    }
+
+private:
+    int position = 0, fadeLength = 0;
+    bool in = true;
+};
+
+//==============================================================================
+/**
+    A Peak/Mid band with drive, run as a TptSvf bell whose added band goes through a BandSaturator, so the
+    harmonics come from what the band boosts (or cuts) and the rest of the signal stays clean.
+*/
+class SaturatedBand
+{
+public:
+    void prepare(double sampleRate);
+    void reset() { svf.reset(); saturator.reset(); }
+
+    void setBand(float frequency, float quality, float gainInDecibels, float driveInDecibels) noexcept;
+
+    // Moving in or out of the chains, over a transition's fade length. Faded out, it needn't be processed.
+    void startFade(bool fadeIn, int length) noexcept { fade.start(fadeIn, length); }
+    void finishFade() noexcept { fade.finish(); }
+    bool isFading() const noexcept { return fade.isActive(); }
+
+    void process(float *samples, int numSamples) noexcept;
+
+private:
+    TptSvf svf;
+    BandSaturator saturator;
+    BandFade fade;
+    double sampleRate = 44100.0;
+};
+
+//==============================================================================
+/**
+    A Peak/Mid band run as a TptSvf with its frequency moved per sample by a BandModulator.
+
+    tan() per sample would cost more than the filter, so the prewarped cutoff comes from a table over log frequency,
+    which leaves a lookup, a lerp and one divide per sample.
+*/
+class ModulatedBand
+{
+public:
+    void prepare(double sampleRate);
+    void reset() { svf.reset(); saturator.reset(); }
+
+    void setBand(float frequency, float quality, float gainInDecibels) noexcept;
+    void setDrive(float decibels) noexcept { saturator.setDrive(decibels); } // saturates the band as SaturatedBand does
+
+    // As SaturatedBand's
+    void startFade(bool fadeIn, int length) noexcept { fade.start(fadeIn, length); }
+    void finishFade() noexcept { fade.finish(); }
+    bool isFading() const noexcept { return fade.isActive(); }
+
+    // offsets is one octave offset per sample, from BandModulator::getOffsets()
+    void process(float *samples, const float *offsets, int numSamples) noexcept;
+
+private:
+    static constexpr int tableSize = 2048;
+
+    TptSvf svf;
+    BandSaturator saturator;
+    BandFade fade;
+    std::vector<double> cutoffTable; // g for tableSize octave steps from minimumOctave to maximumOctave
+    double minimumOctave = 0.0, maximumOctave = 1.0, stepsPerOctave = 1.0;
+    double centreOctave = 0.0;
+};
@@ -0,0 +1,305 @@
+#include "MultirateLowBand.h"
+
+namespace
+{
+    constexpr double routingToleranceInDecibels = 0.01 / 3.0; // shared between the three bands that can move
+    constexpr double routingFloor = 0.001; // below -60 dB a band's cut is already deep enough, whatever the rate
+}
+
+//==============================================================================
+void MultirateLowBand::HalfBandStage::prepare(int length, double beta)
+{
+    // Kaiser windowed half-band lowpass: every other tap away from the centre is exactly zero
+    std::vector<double> window((size_t) length);
+    juce::dsp::WindowingFunction<double>::fillWindowingTables(window.data(), (size_t) length, juce::dsp::WindowingFunction<double>::kaiser, false, beta);
+
+    delay = (length - 1) / 2;
+    coefficients.assign((size_t) length, 0.0);
+
+    double sum = 0;
+    for (int k = 0; k < length; ++k)
+    {
+        auto offset = k - delay;
+        auto sinc = offset == 0 ? 0.5 : std::sin(juce::MathConstants<double>::halfPi * offset) / (juce::MathConstants<double>::pi * offset);
+        coefficients[(size_t) k] = sinc * window[(size_t) k];
+        sum += coefficients[(size_t) k];
+    }
+
+    for (auto &c : coefficients)
+        c /= sum; // unity gain at DC
+
+    // Folds taps spanning `span` samples into mirror pairs, from the lower delay of each
+    auto fold = [this](std::vector<Tap> &folded, int span, int first, int step, double gain)
+    {
+        folded.clear();
+        for (int d = 0; 2 * d <= span - 1; ++d)
+        {
+            auto c = coefficients[(size_t) (first + step * d)];
+            if (std::abs(c) >= 1.0e-12)
+                folded.push_back({ d, span - 1 - d, (2 * d == span - 1 ? 0.5 : 1.0) * gain * c });
+        }
+    };
+
+    // Interpolating by 2 zero-stuffs the input, so each output phase only sees every other tap (at twice the gain)
+    fold(taps, length, 0, 1, 1.0);
+    fold(evenPhase, (length + 1) / 2, 0, 2, 2.0);
+    fold(oddPhase, length / 2, 1, 2, 2.0);
+
+    auto size = juce::nextPowerOfTwo(length);
+    mask = size - 1;
+    downHistory.assign((size_t) (2 * size), 0.0);
+    upHistory.assign((size_t) (2 * size), 0.0);
+}
+
+void MultirateLowBand::HalfBandStage::reset()
+{
+    std::fill(downHistory.begin(), downHistory.end(), 0.0);
+    std::fill(upHistory.begin(), upHistory.end(), 0.0);
+    downPosition = upPosition = 0;
+}
+
+void MultirateLowBand::HalfBandStage::pushDown(double input) noexcept
+{
+    downPosition = (downPosition + 1) & mask;
+    downHistory[(size_t) downPosition] = downHistory[(size_t) (downPosition + mask + 1)] = input;
+}
+
+double MultirateLowBand::HalfBandStage::decimate() const noexcept
+{
+    auto *newest = downHistory.data() + downPosition + mask + 1;
+
+    double output = 0;
+    for (auto &tap : taps)
+        output += tap.gain * (newest[-tap.delay] + newest[-tap.mirrorDelay]);
+    return output;
+}
+
+void MultirateLowBand::HalfBandStage::pushUp(double input) noexcept
+{
+    upPosition = (upPosition + 1) & mask;
+    upHistory[(size_t) upPosition] = upHistory[(size_t) (upPosition + mask + 1)] = input;
+}
+
+double MultirateLowBand::HalfBandStage::interpolate(bool odd) const noexcept
+{
+    auto *newest = upHistory.data() + upPosition + mask + 1;
+
+    double output = 0;
+    for (auto &tap : odd ? oddPhase : evenPhase)
+        output += tap.gain * (newest[-tap.delay] + newest[-tap.mirrorDelay]);
+    return output;
+}
+
+double MultirateLowBand::HalfBandStage::getAmplitude(double normalisedFrequency) const
+{
+    // Zero phase, so each pair is a cosine at its distance from the centre (and the centre's half gain counts twice)
+    double amplitude = 0;
+    for (auto &tap : taps)
+        amplitude += 2.0 * tap.gain * std::cos(juce::MathConstants<double>::twoPi * normalisedFrequency * (tap.mirrorDelay - delay));
+    return amplitude;
+}
+
+//==============================================================================
+void MultirateLowBand::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    // Halve until the next halving would drop below 44.1 kHz: 4x at 176.4/192 kHz, 8x at 352.8/384 kHz
+    numStages = 0;
+    if (sampleRate >= minimumSampleRate)
+        while (numStages < maxStages && sampleRate / (2 << numStages) >= 44100.0)
+            ++numStages;
+
+    reducedSampleRate = sampleRate / (1 << numStages);
+
+    // The last stage sets the edge of the reduced band and needs the sharp transition; the earlier ones only have
+    // to keep their images out of it, which a short filter does
+    latency = 0;
+    for (int s = 0; s < numStages; ++s)
+    {
+        stages[s].prepare(s == numStages - 1 ? 39 : 19, 8.0);
+        latency += 2 * stages[s].delay * (1 << s); // down and back up, at the stage's rate
+    }
+
+    routeFrequencies.clear();
+    transferGain.clear();
+    for (int i = 0; i < 256; ++i)
+    {
+        auto frequency = 10.0 * std::pow(0.49 * sampleRate / 10.0, i / 255.0);
+        auto gain = 1.0;
+        for (int s = 0; s < numStages; ++s)
+        {
+            auto amplitude = stages[s].getAmplitude(frequency * (1 << s) / sampleRate);
+            gain *= amplitude * amplitude;
+        }
+
+        routeFrequencies.push_back(frequency);
+        transferGain.push_back(gain);
+    }
+
+    directPath.assign((size_t) juce::jmax(1, latency), 0.f);
+    numSections = 0;
+    reset();
+}
+
+void MultirateLowBand::reset()
+{
+    for (auto &stage : stages)
+        stage.reset();
+
+    for (auto &state : sectionState)
+        state[0] = state[1] = 0.0;
+
+    std::fill(directPath.begin(), directPath.end(), 0.f);
+    directPosition = 0;
+    tick = 0;
+}
+
+double MultirateLowBand::errorIfMoved(const BiquadCoefficients *fullRate, const BiquadCoefficients *reduced, int count) const
+{
+    auto response = [count](const BiquadCoefficients *cascade, double frequency, double rate)
+    {
+        std::complex<double> h = 1.0;
+        for (int k = 0; k < count; ++k)
+            h *= getResponseForFrequency(cascade[k], frequency, rate);
+        return h;
+    };
+
+    double worst = 0;
+    for (size_t i = 0; i < routeFrequencies.size(); ++i)
+    {
+        auto frequency = routeFrequencies[i];
+        auto wanted = response(fullRate, frequency, sampleRate);
+
+        // Above the reduced Nyquist the low band carries nothing, so the band's effect there is lost entirely
+        std::complex<double> got = 1.0;
+        if (frequency < 0.5 * reducedSampleRate)
+            got += transferGain[i] * (response(reduced, frequency, reducedSampleRate) - 1.0);
+
+        auto wantedMagnitude = std::abs(wanted), gotMagnitude = std::abs(got);
+        if (juce::jmax(wantedMagnitude, gotMagnitude) > routingFloor)
+            worst = juce::jmax(worst, std::abs(juce::Decibels::gainToDecibels(gotMagnitude, -120.0) - juce::Decibels::gainToDecibels(wantedMagnitude, -120.0)));
+    }
+
+    return worst;
+}
+
+MultirateLowBand::Routing MultirateLowBand::route(const ChainSettings &chainSettings) const
+{
+    Routing routing;
+    if (!isAvailable())
+        return routing;
+
+    BiquadCoefficients fullRate[maxCutSections], reduced[maxCutSections];
+    auto count = makeLowCutBiquads(chainSettings, sampleRate, fullRate);
+    makeLowCutBiquads(chainSettings, reducedSampleRate, reduced);
+    routing.lowCut = errorIfMoved(fullRate, reduced, count) < routingToleranceInDecibels;
+
+    fullRate[0] = makePeakBiquad(chainSettings, sampleRate);
+    reduced[0] = makePeakBiquad(chainSettings, reducedSampleRate);
+    routing.peak = errorIfMoved(fullRate, reduced, 1) < routingToleranceInDecibels;
+
+    fullRate[0] = makeMidBiquad(chainSettings, sampleRate);
+    reduced[0] = makeMidBiquad(chainSettings, reducedSampleRate);
+    routing.mid = errorIfMoved(fullRate, reduced, 1) < routingToleranceInDecibels;
+
+    return routing;
+}
+
+void MultirateLowBand::setSections(const ChainSettings &chainSettings, const Routing &routing) noexcept
+{
+    auto previousCount = numSections;
+
+    numSections = 0;
+    if (routing.lowCut)
+        numSections += makeLowCutBiquads(chainSettings, reducedSampleRate, sections);
+    if (routing.peak)
+        sections[numSections++] = makePeakBiquad(chainSettings, reducedSampleRate);
+    if (routing.mid)
+        sections[numSections++] = makeMidBiquad(chainSettings, reducedSampleRate);
+
+    if (numSections != previousCount) // sections moved between slots, so their states no longer line up
+        for (auto &state : sectionState)
+            state[0] = state[1] = 0.0;
+
+    if (previousCount == 0 && numSections > 0) // the half-band filters were skipped, so their histories are stale
+        for (int s = 0; s < numStages; ++s)
+            stages[s].reset();
+}
+
+void MultirateLowBand::process(float *samples, int numSamples) noexcept
+{
+    if (numStages == 0)
+        return;
+
+    if (numSections == 0)
+    {
+        // Nothing to add, so only the delay that keeps the latency the same
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto delayed = directPath[(size_t) directPosition];
+            directPath[(size_t) directPosition] = samples[i];
+            if (++directPosition == (int) directPath.size())
+                directPosition = 0;
+            samples[i] = delayed;
+        }
+
+        tick = (tick + numSamples) & ((1 << maxStages) - 1);
+        return;
+    }
+
+    auto deepest = numStages - 1;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        double input = samples[i];
+
+        auto delayed = directPath[(size_t) directPosition];
+        directPath[(size_t) directPosition] = (float) input;
+        if (++directPosition == (int) directPath.size())
+            directPosition = 0;
+
+        // Down: stage s takes every 2^s-th sample and produces every other one of those
+        auto value = input;
+        auto reachedReducedRate = false;
+        for (int s = 0; s < numStages; ++s)
+        {
+            stages[s].pushDown(value);
+            if ((tick & ((2 << s) - 1)) != 0)
+                break;
+
+            value = stages[s].decimate();
+            reachedReducedRate = s == deepest;
+        }
+
+        // At the reduced rate: keep only what the sections change
+        if (reachedReducedRate)
+        {
+            auto processed = value;
+            for (int k = 0; k < numSections; ++k)
+            {
+                const auto &c = sections[k];
+                processed = processBiquadSample(processed, c.b0, c.b1, c.b2, c.a1, c.a2, sectionState[k][0], sectionState[k][1]);
+            }
+
+            stages[deepest].pushUp(processed - value);
+        }
+
+        // Up: stage s emits one sample every 2^s ticks, into the next stage out or finally the output
+        auto difference = 0.0;
+        for (int s = deepest; s >= 0; --s)
+        {
+            if ((tick & ((1 << s) - 1)) != 0)
+                continue;
+
+            auto output = stages[s].interpolate(((tick >> s) & 1) != 0);
+            if (s > 0)
+                stages[s - 1].pushUp(output);
+            else
+                difference = output;
+        }
+
+        samples[i] = (float) (delayed + difference);
+        tick = (tick + 1) & ((1 << maxStages) - 1);
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "BiquadDesign.h"
+
+//==============================================================================
+/**
+    Runs low-frequency sections at a reduced sample rate for 176.4 kHz and up.
+
+    At those rates a 30 Hz cut or a 60 Hz peak has its poles crowded against z = 1, which costs precision, and it
+    runs at the full rate for no benefit. Here the input is decimated by 4 or 8 through a cascade of half-band FIRs,
+    the sections run at the reduced rate, and only their effect (processed minus unprocessed) is interpolated
+    back and added to the delayed input:
+
+        y = x delayed + interpolate(H(d) - d),  d = decimate(x)
+
+    The half-band filters are linear phase, so the recombination is phase coherent. Bands that still change the
+    response near the top of the reduced band stay at the full rate; route() decides that per band.
+
+    The latency is the same whether or not anything is routed, so it only changes when the low band is switched in
+    or out: with no sections loaded, process() only runs the delay line and skips the decimation and interpolation.
+    Switching is the caller's to crossfade; LowBandChain runs the low band as part of one side of a ChainTransition.
+*/
+class MultirateLowBand
+{
+public:
+    static constexpr double minimumSampleRate = 176400.0;
+
+    void prepare(double sampleRate);
+    void reset();
+
+    bool isAvailable() const noexcept { return numStages > 0; }
+    int getLatencySamples() const noexcept { return latency; }
+    double getReducedSampleRate() const noexcept { return reducedSampleRate; }
+
+    struct Routing
+    {
+        bool lowCut = false, peak = false, mid = false; // true for bands that run in the low band
+    };
+
+    // Moves a band when running it at the reduced rate changes the overall response by less than 0.01 dB anywhere.
+    // Evaluates the responses on a frequency grid, so only call it when the settings actually change.
+    Routing route(const ChainSettings &chainSettings) const;
+
+    // Loads the sections for the routed bands, designed at the reduced rate. Doesn't allocate.
+    void setSections(const ChainSettings &chainSettings, const Routing &routing) noexcept;
+
+    void process(float *samples, int numSamples) noexcept;
+
+private:
+    struct HalfBandStage
+    {
+        // The filter is symmetric, so each tap that isn't zero is paired with its mirror image and the two samples are
+        // added before multiplying, halving the multiplies. The centre tap pairs with itself at half its gain.
+        struct Tap
+        {
+            int delay = 0, mirrorDelay = 0;
+            double gain = 0;
+        };
+
+        std::vector<double> coefficients;
+        std::vector<Tap> taps, evenPhase, oddPhase; // for decimating and for each interpolator phase
+
+        // Rings of a power of two, stored twice over so the taps read back from the newest sample without wrapping
+        std::vector<double> downHistory, upHistory;
+        int downPosition = 0, upPosition = 0, mask = 0;
+        int delay = 0; // group delay in samples at the stage's high rate
+
+        void prepare(int length, double beta);
+        void reset();
+        void pushDown(double input) noexcept;
+        double decimate() const noexcept;
+        void pushUp(double input) noexcept;
+        double interpolate(bool odd) const noexcept;
+        double getAmplitude(double normalisedFrequency) const; // zero-phase response, frequency / the stage's high rate
+    };
+
+    double errorIfMoved(const BiquadCoefficients *fullRate, const BiquadCoefficients *reduced, int count) const;
+
+    static constexpr int maxStages = 3;
+    HalfBandStage stages[maxStages];
+    int numStages = 0, latency = 0, tick = 0;
+    double sampleRate = 44100.0, reducedSampleRate = 44100.0;
+
+    std::vector<double> routeFrequencies, transferGain; // what decimating and interpolating again does to each frequency
+
+    BiquadCoefficients sections[maxChainSections];
+    double sectionState[maxChainSections][2] {};
+    int numSections = 0;
+
+    std::vector<float> directPath; // the input delayed by the latency
+    int directPosition = 0;
+};
+
+// A mono chain followed by a low band, as one chain for ChainTransition, to crossfade the low band in or out
+template<typename ChainType>
+struct LowBandChain
+{
+    ChainType &chain;
+    MultirateLowBand &lowBand;
+
+    void reset() { chain.reset(); lowBand.reset(); }
+
+    template<typename ProcessContext>
+    void process(const ProcessContext &context)
+    {
+        chain.process(context);
+
+        auto &block = context.getOutputBlock();
+        lowBand.process(block.getChannelPointer(0), (int) block.getNumSamples());
+    }
+};
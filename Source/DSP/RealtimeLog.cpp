@@ -0,0 +1,143 @@
+#include "RealtimeLog.h"
+
+//==============================================================================
+RealtimeLog::Channel::Channel(const juce::String &channelName)
+    : name([&channelName]
+           {
+               static std::atomic<int> instanceCount {0};
+               return channelName + " #" + juce::String(++instanceCount); // tells instances in the same host apart
+           }()),
+      writer(RealtimeLog::getShared())
+{
+    writer->add(*this);
+}
+
+RealtimeLog::Channel::~Channel()
+{
+    writer->remove(*this);
+}
+
+//==============================================================================
+std::shared_ptr<RealtimeLog> RealtimeLog::getShared()
+{
+    static std::mutex lock;
+    static std::weak_ptr<RealtimeLog> shared;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (auto existing = shared.lock())
+        return existing;
+
+    std::shared_ptr<RealtimeLog> log(new RealtimeLog());
+    shared = log;
+    return log;
+}
+
+RealtimeLog::RealtimeLog()
+    : pool(WorkerPool::getShared()),
+      logFile(juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory).getChildFile("FiltEQ").getChildFile("Logs").getChildFile("FiltEQ.log")),
+      startTicks(juce::Time::getHighResolutionTicks()),
+      startTime(juce::Time::getCurrentTime())
+{
+    pool->add(*this);
+}
+
+RealtimeLog::~RealtimeLog()
+{
+    pool->remove(*this);
+}
+
+const char* RealtimeLog::getEventName(Event event) noexcept
+{
+    switch (event)
+    {
+        case Event::unstableDesign:    return "unstable design";
+        case Event::nonFiniteOutput:   return "non-finite output";
+        case Event::blockOverrun:      return "block overrun";
+        case Event::transitionStarted: return "transition started";
+        case Event::presetApplied:     return "preset applied";
+        case Event::numEvents:         break;
+    }
+
+    return "unknown event";
+}
+
+void RealtimeLog::add(Channel &channel)
+{
+    std::lock_guard<std::mutex> guard(channelLock);
+    channels.push_back(&channel);
+}
+
+void RealtimeLog::remove(Channel &channel)
+{
+    juce::String text;
+    {
+        std::lock_guard<std::mutex> guard(channelLock);
+        format(channel, text); // whatever the instance logged just before it went away
+        channels.erase(std::remove(channels.begin(), channels.end(), &channel), channels.end());
+    }
+
+    append(text);
+}
+
+void RealtimeLog::drain()
+{
+    juce::String text;
+    {
+        std::lock_guard<std::mutex> guard(channelLock);
+        for (auto *channel : channels)
+            format(*channel, text);
+    }
+
+    append(text);
+}
+
+void RealtimeLog::format(Channel &channel, juce::String &text)
+{
+    auto position = channel.readPosition.load(std::memory_order_relaxed);
+    auto end = channel.writePosition.load(std::memory_order_acquire);
+
+    for (; position != end; ++position)
+    {
+        const auto &record = channel.records[position & (Channel::capacity - 1)];
+        auto time = startTime + juce::RelativeTime(juce::Time::highResolutionTicksToSeconds(record.ticks - startTicks));
+
+        text << time.formatted("%Y-%m-%d %H:%M:%S.") << juce::String(time.getMilliseconds()).paddedLeft('0', 3)
+             << "  " << channel.name << "  " << getEventName(record.event);
+
+        for (auto value : record.values)
+            text << "  " << juce::String(value);
+
+        text << juce::newLine;
+    }
+
+    // Only now can the audio thread reuse the slots
+    channel.readPosition.store(position, std::memory_order_release);
+
+    if (auto dropped = channel.dropped.exchange(0, std::memory_order_relaxed))
+        text << juce::Time::getCurrentTime().formatted("%Y-%m-%d %H:%M:%S") << "  " << channel.name << "  "
+             << (int) dropped << " records dropped, the ring was full" << juce::newLine;
+}
+
+void RealtimeLog::append(const juce::String &text)
+{
+    if (text.isEmpty())
+        return;
+
+    std::lock_guard<std::mutex> guard(fileLock);
+    logFile.getParentDirectory().createDirectory();
+
+    if (logFile.getSize() + (juce::int64) text.getNumBytesAsUTF8() > maximumFileSize)
+    {
+        auto numbered = [this](int index) { return logFile.getSiblingFile("FiltEQ." + juce::String(index) + ".log"); };
+
+        numbered(numKeptFiles - 1).deleteFile();
+        for (int index = numKeptFiles - 2; index >= 1; --index)
+            numbered(index).moveFileTo(numbered(index + 1));
+        logFile.moveFileTo(numbered(1));
+    }
+
+    juce::FileOutputStream stream(logFile); // appends to an existing file
+    if (stream.openedOk())
+        stream.writeText(text, false, false, nullptr);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "WorkerPool.h"
+
+// Set to 0 to compile every diagnostic out: FILTEQ_LOG expands to nothing and the processor drops its channel
+#ifndef FILTEQ_REALTIME_LOG
+ #define FILTEQ_REALTIME_LOG 1
+#endif
+
+//==============================================================================
+/**
+    A diagnostic log the audio thread can write to.
+
+    Each Channel is a preallocated single-producer ring of fixed-size binary records (timestamp, event, four
+    values); write() is a handful of stores and one release, never waits and never allocates, and drops the
+    record (counting it) if the ring is full, then asks for a low priority WorkerPool run. That run, shared by
+    every channel in the process, formats whatever has arrived and appends it to FiltEQ/Logs/FiltEQ.log in the
+    user's application data folder, rotating the file at 1 MB and keeping the last few.
+
+    A channel must only be written from one thread at a time, which is what processBlock guarantees.
+*/
+class RealtimeLog : private WorkerPool::Job
+{
+public:
+    enum class Event : juce::uint32
+    {
+        unstableDesign,    // MonoChain section index, a1, a2, sample rate
+        nonFiniteOutput,   // channel, block size
+        blockOverrun,      // microseconds taken, microseconds available, block size
+        transitionStarted, // old and new low cut slope, old and new high cut slope
+        presetApplied,     // same values, for the transition a loaded preset starts
+        numEvents
+    };
+
+    struct Record
+    {
+        juce::int64 ticks; // juce::Time::getHighResolutionTicks()
+        Event event;
+        juce::uint32 unused;
+        float values[4];
+    };
+
+    class Channel
+    {
+    public:
+        explicit Channel(const juce::String &name);
+        ~Channel();
+
+        void write(Event event, float value0 = 0.f, float value1 = 0.f, float value2 = 0.f, float value3 = 0.f) noexcept
+        {
+            auto position = writePosition.load(std::memory_order_relaxed);
+            if (position - readPosition.load(std::memory_order_acquire) >= capacity)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            auto &record = records[position & (capacity - 1)];
+            record.ticks = juce::Time::getHighResolutionTicks();
+            record.event = event;
+            record.values[0] = value0;
+            record.values[1] = value1;
+            record.values[2] = value2;
+            record.values[3] = value3;
+            writePosition.store(position + 1, std::memory_order_release);
+            writer->schedule(WorkerPool::Priority::low);
+        }
+
+    private:
+        friend class RealtimeLog;
+        static constexpr juce::uint64 capacity = 1024;
+
+        const juce::String name;
+        std::unique_ptr<Record[]> records { new Record[capacity] };
+        std::atomic<juce::uint64> writePosition {0}, readPosition {0};
+        std::atomic<juce::uint32> dropped {0};
+        std::shared_ptr<RealtimeLog> writer;
+    };
+
+    ~RealtimeLog() override;
+
+    static const char* getEventName(Event event) noexcept;
+
+private:
+    RealtimeLog();
+    static std::shared_ptr<RealtimeLog> getShared();
+
+    void add(Channel &channel);
+    void remove(Channel &channel);
+    void run() override { drain(); }
+    void drain();
+    void format(Channel &channel, juce::String &text);
+    void append(const juce::String &text);
+
+    static constexpr juce::int64 maximumFileSize = 1 << 20;
+    static constexpr int numKeptFiles = 4; // FiltEQ.log plus FiltEQ.1.log to FiltEQ.3.log
+
+    std::shared_ptr<WorkerPool> pool;
+    std::mutex channelLock; // only the writer and channel construction/destruction take it, never the audio thread
+    std::vector<Channel*> channels;
+    std::mutex fileLock; // a channel going away appends from its own thread
+    juce::File logFile;
+    juce::int64 startTicks = 0;
+    juce::Time startTime;
+};
+
+#if FILTEQ_REALTIME_LOG
+ #define FILTEQ_LOG(channel, ...) (channel).write(__VA_ARGS__)
+#else
+ #define FILTEQ_LOG(channel, ...) ((void) 0)
+#endif
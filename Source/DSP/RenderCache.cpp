@@ -0,0 +1,204 @@
+#include "RenderCache.h"
+
+namespace
+{
+    constexpr juce::uint32 fileMagic = 0x43525146; // "FQRC"
+    constexpr juce::uint32 fileVersion = 1;
+
+    struct FileHeader
+    {
+        juce::uint32 magic, version;
+        juce::int32 numChannels, maximumBlockSize, stateSize;
+        juce::uint32 generation;
+        juce::int64 numSlots;
+    };
+
+    constexpr size_t fileHeaderBytes = 64;
+
+    inline juce::uint64 rotate(juce::uint64 value, int bits) noexcept { return (value << bits) | (value >> (64 - bits)); }
+
+    inline juce::uint64 finalise(juce::uint64 value) noexcept // murmur3's fmix64
+    {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdull;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ull;
+        value ^= value >> 33;
+        return value;
+    }
+}
+
+//==============================================================================
+void RenderCache::KeyBuilder::add(const void *data, size_t numBytes) noexcept
+{
+    auto *bytes = static_cast<const char*>(data);
+    length += numBytes;
+
+    // Two lanes with different mixing, so the 128 bits aren't just one 64-bit hash twice
+    for (; numBytes >= 8; bytes += 8, numBytes -= 8)
+    {
+        juce::uint64 word;
+        std::memcpy(&word, bytes, 8);
+        low = rotate(low ^ (word * 0x87c37b91114253d5ull), 31) * 0x4cf5ad432745937full;
+        high = rotate(high + word, 27) * 0x52dce729ull + 0x38495ab5ull;
+    }
+
+    if (numBytes > 0)
+    {
+        juce::uint64 word = 0;
+        std::memcpy(&word, bytes, numBytes);
+        low = rotate(low ^ (word * 0x87c37b91114253d5ull), 31) * 0x4cf5ad432745937full;
+        high = rotate(high + word, 27) * 0x52dce729ull + 0x38495ab5ull;
+    }
+}
+
+void RenderCache::KeyBuilder::add(const ChainSettings &chainSettings, double sampleRate) noexcept
+{
+    // Field by field, so padding never gets into the key
+    const float values[] = { chainSettings.midFreq, chainSettings.midGainInDecibels, chainSettings.midQuality,
+                             chainSettings.peakFreq, chainSettings.peakGainInDecibels, chainSettings.peakQuality,
+                             chainSettings.lowCutFreq, chainSettings.highCutFreq,
+                             (float) chainSettings.lowCutSlope, (float) chainSettings.highCutSlope };
+    add(values, sizeof(values));
+    add(&sampleRate, sizeof(sampleRate));
+}
+
+RenderCache::Key RenderCache::KeyBuilder::getKey() const noexcept
+{
+    auto a = finalise(low ^ length);
+    auto b = finalise(high + length);
+    return { a + b, b + 2 * a };
+}
+
+//==============================================================================
+RenderCache::~RenderCache()
+{
+    close();
+}
+
+bool RenderCache::open(const juce::File &file, juce::int64 maximumBytes, int channels, int blockSize, int numStateFloats)
+{
+    close();
+
+    numChannels = channels;
+    maximumBlockSize = blockSize;
+    stateSize = numStateFloats;
+
+    slotBytes = sizeof(SlotHeader) + sizeof(float) * (size_t) (numChannels * maximumBlockSize + stateSize);
+    slotBytes = (slotBytes + 63) & ~(size_t) 63; // cache line aligned
+    numSlots = juce::jmax((juce::int64) 1, (maximumBytes - (juce::int64) fileHeaderBytes) / (juce::int64) slotBytes);
+
+    auto totalBytes = (juce::int64) fileHeaderBytes + numSlots * (juce::int64) slotBytes;
+
+    if (file.getSize() != totalBytes)
+    {
+        file.deleteFile();
+        file.getParentDirectory().createDirectory();
+
+        juce::FileOutputStream output(file);
+        if (!output.openedOk() || !output.setPosition(totalBytes - 1) || !output.writeByte(0))
+            return false;
+    }
+
+    map = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readWrite, false);
+    if (map->getData() == nullptr || (juce::int64) map->getSize() < totalBytes)
+    {
+        map.reset();
+        return false;
+    }
+
+    auto *base = static_cast<char*>(map->getData());
+    slots = base + fileHeaderBytes;
+
+    FileHeader existing;
+    std::memcpy(&existing, base, sizeof(FileHeader));
+
+    auto matches = existing.magic == fileMagic && existing.version == fileVersion && existing.numChannels == numChannels
+                && existing.maximumBlockSize == maximumBlockSize && existing.stateSize == stateSize && existing.numSlots == numSlots;
+
+    if (matches && existing.generation != 0)
+    {
+        generation = existing.generation;
+    }
+    else
+    {
+        // New, or laid out for other sizes: whatever the slots hold is meaningless now. A fresh file reads as zeros,
+        // so generations start at 1.
+        generation = existing.magic == fileMagic ? juce::jmax(1u, existing.generation + 1) : 1u;
+        FileHeader header { fileMagic, fileVersion, numChannels, maximumBlockSize, stateSize, generation, numSlots };
+        std::memcpy(base, &header, sizeof(FileHeader));
+    }
+
+    hits = misses = 0;
+    return true;
+}
+
+void RenderCache::close()
+{
+    map.reset();
+    slots = nullptr;
+}
+
+char* RenderCache::getSlot(const Key &key) const noexcept
+{
+    return slots + (juce::int64) (key.low % (juce::uint64) numSlots) * (juce::int64) slotBytes;
+}
+
+bool RenderCache::fetch(const Key &key, float* const* channels, int numSamples, float *state) noexcept
+{
+    if (map == nullptr || numSamples > maximumBlockSize || numSamples <= 0)
+        return false;
+
+    auto *slot = getSlot(key);
+    auto *header = reinterpret_cast<volatile SlotHeader*>(slot);
+
+    if (header->keyLow != key.low || header->keyHigh != key.high || header->numSamples != numSamples || header->generation != generation)
+    {
+        ++misses;
+        return false;
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    auto *data = reinterpret_cast<const float*>(slot + sizeof(SlotHeader));
+    for (int channel = 0; channel < numChannels; ++channel)
+        std::memcpy(channels[channel], data + channel * maximumBlockSize, sizeof(float) * (size_t) numSamples);
+    std::memcpy(state, data + numChannels * maximumBlockSize, sizeof(float) * (size_t) stateSize);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // Someone else may have rewritten the slot while we copied; their new key would show it
+    if (header->keyLow != key.low || header->keyHigh != key.high)
+    {
+        ++misses;
+        return false;
+    }
+
+    ++hits;
+    return true;
+}
+
+void RenderCache::store(const Key &key, const float* const* channels, int numSamples, const float *state) noexcept
+{
+    if (map == nullptr || numSamples > maximumBlockSize || numSamples <= 0)
+        return;
+
+    auto *slot = getSlot(key);
+    auto *header = reinterpret_cast<volatile SlotHeader*>(slot);
+
+    // Invalidate first and publish the key last, so a reader never matches a half-written slot
+    header->keyLow = 0;
+    header->keyHigh = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto *data = reinterpret_cast<float*>(slot + sizeof(SlotHeader));
+    for (int channel = 0; channel < numChannels; ++channel)
+        std::memcpy(data + channel * maximumBlockSize, channels[channel], sizeof(float) * (size_t) numSamples);
+    std::memcpy(data + numChannels * maximumBlockSize, state, sizeof(float) * (size_t) stateSize);
+    header->numSamples = numSamples;
+    header->generation = generation;
+
+    std::atomic_thread_fence(std::memory_order_release);
+    header->keyHigh = key.high;
+    header->keyLow = key.low;
+}
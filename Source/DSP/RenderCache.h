@@ -0,0 +1,71 @@
+#pragma once
+
+#include "FilterChain.h"
+
+//==============================================================================
+/**
+    A content-addressed cache of processed blocks for offline renders, kept in a bounded memory-mapped file.
+
+    A block is identified by a 128-bit hash of everything that determines its output: the chain settings and
+    sample rate, the filter state it starts from and the input samples. A hit hands back the stored output and the
+    state the filters ended in, so the next block's key (and processing, if that one misses) carries on exactly as if
+    the block had been processed. Anything that isn't found is simply processed and stored.
+
+    The file holds a fixed number of equally sized slots and a block can only live in the slot its key selects, so
+    the file never grows and a newer block evicts whatever shared its slot. The file is created sparse and resetting
+    it only bumps a generation number, so opening it never has to write the whole thing. Slots are written key-last and checked
+    again after reading, so several instances (or processes) using the same file at once only ever cost misses.
+*/
+class RenderCache
+{
+public:
+    struct Key
+    {
+        juce::uint64 low = 0, high = 0;
+    };
+
+    // Accumulates the pieces of a key. Cheap next to filtering a block: one multiply per 8 bytes per lane.
+    class KeyBuilder
+    {
+    public:
+        void add(const void *data, size_t numBytes) noexcept;
+        void add(const ChainSettings &chainSettings, double sampleRate) noexcept;
+        Key getKey() const noexcept;
+
+    private:
+        juce::uint64 low = 0x9e3779b97f4a7c15ull, high = 0xc2b2ae3d27d4eb4full, length = 0;
+    };
+
+    ~RenderCache();
+
+    // Maps (creating or resizing if needed) a cache file of about maximumBytes whose slots fit numChannels x
+    // maximumBlockSize samples plus stateSize floats of filter state. A file laid out for other sizes is reset.
+    bool open(const juce::File &file, juce::int64 maximumBytes, int numChannels, int maximumBlockSize, int stateSize);
+    void close();
+    bool isOpen() const noexcept { return map != nullptr; }
+
+    // On a hit copies the stored output into channels and the end state into state, and returns true
+    bool fetch(const Key &key, float* const* channels, int numSamples, float *state) noexcept;
+    void store(const Key &key, const float* const* channels, int numSamples, const float *state) noexcept;
+
+    juce::int64 getNumHits() const noexcept { return hits; }
+    juce::int64 getNumMisses() const noexcept { return misses; }
+
+private:
+    struct SlotHeader
+    {
+        juce::uint64 keyLow, keyHigh;
+        juce::int32 numSamples;
+        juce::uint32 generation; // slots from before the file was last reset don't count
+    };
+
+    char* getSlot(const Key &key) const noexcept;
+
+    std::unique_ptr<juce::MemoryMappedFile> map;
+    char *slots = nullptr;
+    juce::int64 numSlots = 0;
+    size_t slotBytes = 0;
+    juce::uint32 generation = 0;
+    int numChannels = 0, maximumBlockSize = 0, stateSize = 0;
+    juce::int64 hits = 0, misses = 0;
+};
@@ -0,0 +1,259 @@
+#include "ResonanceSuppressor.h"
+
+void ResonanceSuppressor::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    fadeLength = juce::jmax(1, juce::roundToInt(fadeMilliseconds * 0.001 * sampleRate));
+
+    for (int i = minimumOrder; i <= maximumOrder; ++i)
+    {
+        auto size = 1 << i;
+        ffts[i - minimumOrder] = std::make_unique<juce::dsp::FFT>(i);
+
+        auto &window = windows[i - minimumOrder];
+        window.resize((size_t) size);
+        for (int j = 0; j < size; ++j)
+            window[(size_t) j] = std::sin(juce::MathConstants<float>::pi * (float) j / (float) size);
+    }
+
+    auto maximumSize = (size_t) 1 << maximumOrder;
+    for (auto &stage : stages)
+    {
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            stage.input[channel].assign(maximumSize, 0.f);
+            stage.output[channel].assign(maximumSize, 0.f);
+        }
+
+        stage.powers.assign(maximumSize / 2 + 1, 0.f);
+        stage.powerSums.assign(maximumSize / 2 + 2, 0.0);
+        stage.reductions.assign(maximumSize / 2 + 1, 0.f);
+        stage.envelopeWidths.assign(maximumSize / 2 + 1, 0);
+        stage.order = 0; // so the next configure() sets everything up for the new rate
+    }
+
+    frame.assign(maximumSize, {});
+    spectrum.assign(maximumSize, {});
+
+    reset();
+}
+
+void ResonanceSuppressor::reset() noexcept
+{
+    live = target = dryPath; // fades back in, if enabled, once a stage has a full FFT again
+}
+
+void ResonanceSuppressor::setLayout(int newOrder, int newOverlap) noexcept
+{
+    order = juce::jlimit(minimumOrder, maximumOrder, newOrder);
+    overlap = juce::jlimit(2, maximumOverlap, newOverlap);
+}
+
+void ResonanceSuppressor::configure(Stage &stage, int newOrder, int newOverlap) noexcept
+{
+    if (newOrder != stage.order || newOverlap != stage.overlap)
+    {
+        stage.order = newOrder;
+        stage.overlap = newOverlap;
+        stage.fftSize = 1 << stage.order;
+        stage.hopSize = stage.fftSize / stage.overlap;
+
+        // One-pole smoothing of the bin powers and of the reduction, stepped once a hop
+        auto hopMilliseconds = 1000.f * (float) stage.hopSize / (float) sampleRate;
+        stage.averaging = 1.f - std::exp(-hopMilliseconds / averagingMilliseconds);
+        stage.attack = 1.f - std::exp(-hopMilliseconds / attackMilliseconds);
+        stage.release = 1.f - std::exp(-hopMilliseconds / releaseMilliseconds);
+
+        // A fixed fraction of an octave either side, but always a few bins besides the ones left out around the centre
+        auto fraction = std::pow(2.0, envelopeOctaves) - 1.0;
+        auto numBins = stage.fftSize / 2 + 1;
+        for (int k = 0; k < numBins; ++k)
+            stage.envelopeWidths[(size_t) k] = juce::jmax(3, (int) (k * fraction));
+    }
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        std::fill(stage.input[channel].begin(), stage.input[channel].end(), 0.f);
+        std::fill(stage.output[channel].begin(), stage.output[channel].end(), 0.f);
+    }
+
+    std::fill(stage.powers.begin(), stage.powers.end(), 0.f);
+    std::fill(stage.reductions.begin(), stage.reductions.end(), 0.f);
+    stage.hopPosition = 0;
+}
+
+void ResonanceSuppressor::startFade() noexcept
+{
+    auto layoutChanged = live != dryPath && (stages[live].order != order || stages[live].overlap != overlap);
+    if (enabled == (live != dryPath) && !layoutChanged)
+        return;
+
+    if (enabled)
+    {
+        // A stage starts from silence, so it runs unheard until its output is a whole FFT of real signal
+        target = live == dryPath ? 0 : 1 - live;
+        configure(stages[target], order, overlap);
+    }
+    else
+    {
+        target = dryPath; // the input itself, so there's nothing to wait for
+    }
+
+    fadePosition = 0;
+}
+
+void ResonanceSuppressor::process(float *left, float *right, int numSamples) noexcept
+{
+    if (live == target)
+        startFade();
+
+    auto numChannels = right != nullptr ? 2 : 1;
+    auto warmup = target != dryPath && target != live ? stages[target].fftSize : 0;
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        auto length = juce::jmin(chunkSize, numSamples - start);
+        float *dry[] = { left + start, right != nullptr ? right + start : nullptr };
+        const float *sources[3][2] {};
+
+        // The stages heard filter copies of the input, which stays in place as the dry path
+        for (int s = 0; s < 2; ++s)
+        {
+            if (s != live && s != target)
+                continue;
+
+            float *wet[] = { stageOutputs[s][0], stageOutputs[s][1] };
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                std::copy(dry[channel], dry[channel] + length, wet[channel]);
+                sources[s][channel] = wet[channel];
+            }
+
+            processStage(stages[s], wet, numChannels, length);
+        }
+
+        sources[dryPath][0] = dry[0];
+        sources[dryPath][1] = dry[1];
+
+        // Both paths filter the same input, so a linear fade is the right one. Where their latencies differ it blurs
+        // the jump in time for the length of the fade.
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto *output = dry[channel];
+            auto *from = sources[live][channel];
+            auto *to = sources[target][channel];
+
+            if (live == target)
+            {
+                if (from != output)
+                    std::copy(from, from + length, output);
+                continue;
+            }
+
+            for (int i = 0; i < length; ++i)
+            {
+                auto gain = juce::jlimit(0.f, 1.f, float(fadePosition + i - warmup) / float(fadeLength));
+                output[i] = from[i] + gain * (to[i] - from[i]);
+            }
+        }
+
+        if (live != target)
+        {
+            fadePosition += length;
+            if (fadePosition >= warmup + fadeLength)
+                live = target;
+        }
+    }
+}
+
+void ResonanceSuppressor::processStage(Stage &stage, float *const *channels, int numChannels, int numSamples) noexcept
+{
+    for (int start = 0; start < numSamples;)
+    {
+        auto length = juce::jmin(numSamples - start, stage.hopSize - stage.hopPosition);
+
+        // In first: the output is the same buffer
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto *samples = channels[channel] + start;
+            std::copy(samples, samples + length, stage.input[channel].data() + (stage.fftSize - stage.hopSize + stage.hopPosition));
+            std::copy(stage.output[channel].data() + stage.hopPosition, stage.output[channel].data() + stage.hopPosition + length, samples);
+        }
+
+        stage.hopPosition += length;
+        start += length;
+
+        if (stage.hopPosition == stage.hopSize)
+        {
+            processFrame(stage);
+            stage.hopPosition = 0;
+        }
+    }
+}
+
+void ResonanceSuppressor::processFrame(Stage &stage) noexcept
+{
+    const auto &window = windows[stage.order - minimumOrder];
+    auto &fft = *ffts[stage.order - minimumOrder];
+
+    for (int j = 0; j < stage.fftSize; ++j)
+        frame[(size_t) j] = { stage.input[0][(size_t) j] * window[(size_t) j], stage.input[1][(size_t) j] * window[(size_t) j] };
+
+    fft.perform(frame.data(), spectrum.data(), false);
+    updateGains(stage);
+    fft.perform(spectrum.data(), frame.data(), true);
+
+    // Root-Hann twice is Hann, whose copies a hop apart sum to overlap / 2
+    auto scale = 2.f / (float) stage.overlap;
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        auto &accumulator = stage.output[channel];
+        std::copy(accumulator.begin() + stage.hopSize, accumulator.begin() + stage.fftSize, accumulator.begin());
+        std::fill(accumulator.begin() + (stage.fftSize - stage.hopSize), accumulator.begin() + stage.fftSize, 0.f);
+
+        for (int j = 0; j < stage.fftSize; ++j)
+        {
+            auto sample = channel == 0 ? frame[(size_t) j].real() : frame[(size_t) j].imag();
+            accumulator[(size_t) j] += sample * window[(size_t) j] * scale;
+        }
+
+        std::copy(stage.input[channel].begin() + stage.hopSize, stage.input[channel].begin() + stage.fftSize, stage.input[channel].begin());
+    }
+}
+
+void ResonanceSuppressor::updateGains(Stage &stage) noexcept
+{
+    auto numBins = stage.fftSize / 2 + 1;
+
+    // Bins k and N - k of the packed spectrum hold left +/- i right, so half their summed power is left's plus right's.
+    // Averaged over a few hops, a noisy bin rarely stands out from its neighbours the way a resonance does.
+    stage.powerSums[0] = 0.0;
+    for (int k = 0; k < numBins; ++k)
+    {
+        auto power = 0.5f * (std::norm(spectrum[(size_t) k]) + std::norm(spectrum[(size_t) ((stage.fftSize - k) & (stage.fftSize - 1))]));
+        auto &smoothed = stage.powers[(size_t) k];
+        smoothed += stage.averaging * (power - smoothed);
+        stage.powerSums[(size_t) k + 1] = stage.powerSums[(size_t) k] + smoothed; // double: the sums span the whole dynamic range
+    }
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        // The bin and its neighbours (a tone's main lobe) are left out, so a resonance doesn't raise its own reference
+        auto width = stage.envelopeWidths[(size_t) k];
+        auto low = juce::jmax(0, k - width), high = juce::jmin(numBins, k + width + 1);
+        auto lobeLow = juce::jmax(0, k - 1), lobeHigh = juce::jmin(numBins, k + 2);
+        auto envelope = (stage.powerSums[(size_t) high] - stage.powerSums[(size_t) low] - stage.powerSums[(size_t) lobeHigh] + stage.powerSums[(size_t) lobeLow])
+                      / double(high - low - (lobeHigh - lobeLow));
+
+        auto excess = 10.f * std::log10((stage.powers[(size_t) k] + 1.0e-20f) / (float) (envelope + 1.0e-20));
+        auto wanted = juce::jlimit(0.f, depth, excess - threshold);
+        auto &reduction = stage.reductions[(size_t) k];
+        reduction += (wanted > reduction ? stage.attack : stage.release) * (wanted - reduction);
+
+        // The same real gain on k and N - k keeps left and right apart
+        auto gain = std::exp(-0.11512925f * reduction); // dB to gain: ln(10) / 20
+        spectrum[(size_t) k] *= gain;
+        if (k > 0 && k < stage.fftSize / 2)
+            spectrum[(size_t) (stage.fftSize - k)] *= gain;
+    }
+}
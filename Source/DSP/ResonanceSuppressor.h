@@ -0,0 +1,95 @@
+#pragma once
+
+#include "FilterChain.h"
+
+//==============================================================================
+/**
+    Tames resonances wherever they turn up in the spectrum, rather than at a fixed frequency like Peak and Mid.
+
+    Short-time Fourier analysis and resynthesis, every hop: each bin's power, averaged over a few hops, is compared
+    with a smoothed envelope of the spectrum around it (a sixth of an octave either side), and a bin standing more
+    than the threshold above it is turned down by the excess, up to the depth. The reduction attacks within a hop or two and releases over
+    about 80 ms, so it follows a resonance as a voice moves but doesn't chatter. Both channels share one reduction,
+    from their summed power, so the stereo image holds.
+
+    Left and right go through one complex FFT each way, as its real and imaginary parts: a real gain applied to bins
+    k and N - k alike filters both at once, and their summed power comes straight from those two bins. Analysis and
+    synthesis windows are root-Hann, which overlap-add back to exactly the input when nothing is reduced.
+
+    Runs on the audio thread, since it changes the signal. prepare() allocates the buffers and an FFT for every size
+    up front, so changing the size or overlap afterwards doesn't. The latency is the FFT size while it's on and nothing
+    while it's off, when it needn't run at all (see isRunning()). A new layout, or switching on, runs beside what's
+    heard until it has a full FFT of input, then takes over in a crossfade. A new size or switching moves the signal
+    in time by the change in latency, which the fade spreads out rather than clicking.
+*/
+class ResonanceSuppressor
+{
+public:
+    static constexpr int minimumOrder = 9, maximumOrder = 12; // 512 to 4096 points
+    static constexpr int maximumOverlap = 8;
+
+    // Not while process() may run
+    void prepare(double sampleRate);
+    void reset() noexcept;
+
+    // Either way the change fades in, once any change already fading has finished
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled = shouldBeEnabled; }
+
+    // False once it's off and any fade out has finished, after which process() would only pass the signal through
+    bool isRunning() const noexcept { return enabled || live != dryPath || target != dryPath; }
+
+    // An FFT of 2^order points, hopping 1/overlap of that (2, 4 or 8)
+    void setLayout(int order, int overlap) noexcept;
+    void setThreshold(float decibels) noexcept { threshold = decibels; }
+    void setDepth(float decibels) noexcept { depth = decibels; }
+
+    // For the layout asked for, so it's right for the host from the moment it changes
+    int getLatencySamples() const noexcept { return enabled ? 1 << order : 0; }
+
+    // right may be nullptr for a mono signal
+    void process(float *left, float *right, int numSamples) noexcept;
+
+private:
+    using Complex = juce::dsp::Complex<float>;
+
+    // One layout's analysis and resynthesis
+    struct Stage
+    {
+        int order = 0, overlap = 0, fftSize = 0, hopSize = 0;
+        float averaging = 1.f, attack = 1.f, release = 1.f; // per hop
+
+        std::vector<float> input[2], output[2]; // the last fftSize samples in, and the overlap-add accumulator out
+        int hopPosition = 0;
+
+        std::vector<float> powers, reductions; // per bin: averaged power, and the smoothed reduction in dB
+        std::vector<double> powerSums;         // running sum of powers, for the envelope
+        std::vector<int> envelopeWidths;       // bins either side that the envelope averages over
+    };
+
+    void configure(Stage &stage, int order, int overlap) noexcept; // and clears it
+    void startFade() noexcept;
+    void processStage(Stage &stage, float *const *channels, int numChannels, int numSamples) noexcept;
+    void processFrame(Stage &stage) noexcept;
+    void updateGains(Stage &stage) noexcept;
+
+    static constexpr float averagingMilliseconds = 20.f, attackMilliseconds = 5.f, releaseMilliseconds = 80.f;
+    static constexpr float fadeMilliseconds = 20.f;
+    static constexpr double envelopeOctaves = 1.0 / 6.0; // either side of each bin
+    static constexpr int chunkSize = 256, dryPath = 2;
+
+    std::unique_ptr<juce::dsp::FFT> ffts[maximumOrder - minimumOrder + 1];
+    std::vector<float> windows[maximumOrder - minimumOrder + 1]; // root-Hann, periodic
+
+    double sampleRate = 44100.0;
+    int order = 10, overlap = 4; // the layout asked for
+    float threshold = 3.f, depth = 6.f;
+    bool enabled = false;
+
+    // What's heard fades from live to target (a stage, or dryPath: the input as it is), starting once a stage target
+    // has a full FFT of input
+    Stage stages[2];
+    int live = dryPath, target = dryPath, fadePosition = 0, fadeLength = 1;
+    float stageOutputs[2][2][chunkSize] {}; // [stage][channel]
+
+    std::vector<Complex> frame, spectrum;
+};
@@ -0,0 +1,229 @@
+#include "StateSpaceFilter.h"
+#include "ChainOptimiser.h"
+
+void BlockStateSpaceFilter::setSections(const BiquadCoefficients *newSections, int numSections)
+{
+    sections.assign(newSections, newSections + numSections);
+    order = 2 * numSections;
+
+    // Compose the cascade one section at a time. Each section on its own is A = [-a1 1; -a2 0], B = [b1 - a1 b0; b2 - a2 b0],
+    // C = [1 0], D = b0, and feeding the cascade so far into it gives A' = [A 0; Bk C  Ak], B' = [B; Bk D], C' = [Dk C  Ck], D' = Dk D
+    std::vector<double> A((size_t) (order * order), 0.0), B((size_t) order, 0.0), C((size_t) order, 0.0);
+    double D = 1.0;
+    auto a = [&](int row, int column) -> double& { return A[(size_t) (column * order + row)]; };
+
+    for (int k = 0; k < numSections; ++k)
+    {
+        const auto &s = sections[(size_t) k];
+        auto first = 2 * k;
+        auto inputGain0 = s.b1 - s.a1 * s.b0, inputGain1 = s.b2 - s.a2 * s.b0;
+
+        for (int column = 0; column < first; ++column) // Bk C: the new section sees the previous output
+        {
+            a(first, column) = inputGain0 * C[(size_t) column];
+            a(first + 1, column) = inputGain1 * C[(size_t) column];
+        }
+
+        a(first, first) = -s.a1;
+        a(first, first + 1) = 1.0;
+        a(first + 1, first) = -s.a2;
+
+        B[(size_t) first] = inputGain0 * D;
+        B[(size_t) first + 1] = inputGain1 * D;
+
+        for (int column = 0; column < first; ++column)
+            C[(size_t) column] *= s.b0;
+        C[(size_t) first] = 1.0;
+
+        D *= s.b0;
+    }
+
+    auto multiply = [this](const std::vector<double> &matrix, const std::vector<double> &vector)
+    {
+        std::vector<double> result((size_t) order, 0.0);
+        for (int column = 0; column < order; ++column)
+            for (int row = 0; row < order; ++row)
+                result[(size_t) row] += matrix[(size_t) (column * order + row)] * vector[(size_t) column];
+        return result;
+    };
+
+    // Markov parameters h[0] = D, h[j] = C A^(j-1) B, and the rows C A^j of the state-to-output matrix
+    impulse.assign((size_t) blockLength, 0.0);
+    stateToOutput.assign((size_t) (blockLength * order), 0.0);
+
+    auto powerTimesB = B; // A^(j-1) B
+    impulse[0] = D;
+    for (int j = 1; j < blockLength; ++j)
+    {
+        for (int i = 0; i < order; ++i)
+            impulse[(size_t) j] += C[(size_t) i] * powerTimesB[(size_t) i];
+        powerTimesB = multiply(A, powerTimesB);
+    }
+
+    // C A^j for j = 0..M-1: build the row vector by multiplying from the right, A^T applied to the previous row
+    auto row = C;
+    for (int j = 0; j < blockLength; ++j)
+    {
+        for (int i = 0; i < order; ++i)
+            stateToOutput[(size_t) (i * blockLength + j)] = row[(size_t) i];
+
+        std::vector<double> next((size_t) order, 0.0);
+        for (int column = 0; column < order; ++column)
+            for (int r = 0; r < order; ++r)
+                next[(size_t) column] += row[(size_t) r] * A[(size_t) (column * order + r)];
+        row = next;
+    }
+
+    // K columns A^(M-1-k) B, i.e. A^0 B in the last column up to A^(M-1) B in the first
+    inputToState.assign((size_t) (order * blockLength), 0.0);
+    auto column = B;
+    for (int k = blockLength - 1; k >= 0; --k)
+    {
+        std::copy(column.begin(), column.end(), inputToState.begin() + k * order);
+        column = multiply(A, column);
+    }
+
+    // A^M, by repeated multiplication of the identity's columns
+    stateTransition.assign((size_t) (order * order), 0.0);
+    for (int c = 0; c < order; ++c)
+    {
+        std::vector<double> basis((size_t) order, 0.0);
+        basis[(size_t) c] = 1.0;
+        for (int j = 0; j < blockLength; ++j)
+            basis = multiply(A, basis);
+        std::copy(basis.begin(), basis.end(), stateTransition.begin() + c * order);
+    }
+
+    // Same number of sections: keep the state, so a stream can change settings without a restart (as the other engines do)
+    if (state.size() != (size_t) order)
+        state.assign((size_t) order, 0.0);
+    nextState.assign((size_t) order, 0.0);
+}
+
+void BlockStateSpaceFilter::setChainSettings(const ChainSettings &chainSettings, double sampleRate)
+{
+    BiquadCoefficients chain[maxChainSections];
+    ChainPlan plan;
+    planChain(chain, makeChainBiquads(chainSettings, sampleRate, chain), plan);
+
+    // Flat and cancelling sections (0 dB peaks, opposite Peak and Mid) would only add states, so leave them out
+    for (int k = 0; k < plan.numUsed; ++k)
+        chain[k] = plan.sections[plan.order[k]];
+
+    setSections(chain, plan.numUsed);
+}
+
+void BlockStateSpaceFilter::reset()
+{
+    std::fill(state.begin(), state.end(), 0.0);
+}
+
+void BlockStateSpaceFilter::process(float *samples, int numSamples) noexcept
+{
+    alignas(32) double input[blockLength], output[blockLength];
+
+    auto numBlocks = numSamples / blockLength;
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        auto *block = samples + b * blockLength;
+        for (int j = 0; j < blockLength; ++j)
+        {
+            input[j] = block[j];
+            output[j] = 0.0;
+        }
+
+        // y = O x
+        for (int i = 0; i < order; ++i)
+        {
+            auto x = state[(size_t) i];
+            const auto *o = stateToOutput.data() + i * blockLength;
+            for (int j = 0; j < blockLength; ++j)
+                output[j] += o[j] * x;
+        }
+
+        // y += T u, one impulse-response-shaped column per input sample
+        for (int k = 0; k < blockLength; ++k)
+        {
+            auto u = input[k];
+            for (int j = k; j < blockLength; ++j)
+                output[j] += impulse[(size_t) (j - k)] * u;
+        }
+
+        // x = A^M x + K u
+        std::fill(nextState.begin(), nextState.end(), 0.0);
+        for (int i = 0; i < order; ++i)
+        {
+            auto x = state[(size_t) i];
+            const auto *column = stateTransition.data() + i * order;
+            for (int r = 0; r < order; ++r)
+                nextState[(size_t) r] += column[r] * x;
+        }
+        for (int k = 0; k < blockLength; ++k)
+        {
+            auto u = input[k];
+            const auto *column = inputToState.data() + k * order;
+            for (int r = 0; r < order; ++r)
+                nextState[(size_t) r] += column[r] * u;
+        }
+        std::swap(state, nextState);
+
+        for (int j = 0; j < blockLength; ++j)
+            block[j] = (float) output[j];
+    }
+
+    processTail(samples + numBlocks * blockLength, numSamples - numBlocks * blockLength);
+}
+
+void BlockStateSpaceFilter::processTail(float *samples, int numSamples) noexcept
+{
+    // The state is each section's transposed direct form II state, so the leftovers can just run through the sections
+    for (size_t k = 0; k < sections.size(); ++k)
+        processBiquad(sections[k], state[2 * k], state[2 * k + 1], samples, numSamples);
+}
+
+BlockStateSpaceFilter::ValidationResult BlockStateSpaceFilter::validate(const ChainSettings &chainSettings, double sampleRate, int numSamples, double tolerance)
+{
+    MonoChain reference;
+    reference.prepare({ sampleRate, (juce::uint32) numSamples, 1 });
+    updateChain(reference, chainSettings, sampleRate);
+
+    BlockStateSpaceFilter filter;
+    filter.setChainSettings(chainSettings, sampleRate);
+
+    juce::AudioBuffer<float> expected(1, numSamples), actual(1, numSamples);
+    juce::Random random(1234);
+    for (int i = 0; i < numSamples; ++i)
+        expected.setSample(0, i, random.nextFloat() * 2.f - 1.f);
+    actual.copyFrom(0, 0, expected, 0, 0, numSamples);
+
+    // The same sections in double precision, to measure how much of the difference is MonoChain's own float rounding
+    std::vector<double> exact(expected.getReadPointer(0), expected.getReadPointer(0) + numSamples);
+    BiquadCoefficients chain[maxChainSections];
+    auto numSections = makeChainBiquads(chainSettings, sampleRate, chain);
+
+    for (int k = 0; k < numSections; ++k)
+    {
+        double s1 = 0, s2 = 0;
+        processBiquad(chain[k], s1, s2, exact.data(), numSamples);
+    }
+
+    juce::dsp::AudioBlock<float> block(expected);
+    juce::dsp::ProcessContextReplacing<float> context(block);
+    reference.process(context);
+
+    // Odd sized calls, so the tail path is checked along with the block path
+    for (int start = 0; start < numSamples; start += 509)
+        filter.process(actual.getWritePointer(0) + start, juce::jmin(509, numSamples - start));
+
+    ValidationResult result;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto expectedSample = (double) expected.getSample(0, i);
+        result.maxError = juce::jmax(result.maxError, std::abs(expectedSample - (double) actual.getSample(0, i)));
+        result.referenceError = juce::jmax(result.referenceError, std::abs(expectedSample - exact[(size_t) i]));
+        result.referencePeak = juce::jmax(result.referencePeak, std::abs(expectedSample));
+    }
+
+    result.passed = result.maxError <= 2.0 * result.referenceError + tolerance * juce::jmax(1.0, result.referencePeak);
+    return result;
+}
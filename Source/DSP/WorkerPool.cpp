@@ -0,0 +1,171 @@
+#include "WorkerPool.h"
+
+class WorkerPool::Worker : public juce::Thread
+{
+public:
+    Worker(WorkerPool &owner, int workerIndex)
+        : juce::Thread("FiltEQ worker " + juce::String(workerIndex + 1)), pool(owner), index(workerIndex) {}
+
+    void run() override
+    {
+        auto interval = pollInterval;
+
+        while (!threadShouldExit())
+        {
+            if (auto *job = pool.claim(index))
+            {
+                job->run();
+                pool.finish(*job, index);
+                interval = pollInterval;
+                continue;
+            }
+
+            // Only the polling worker wakes by itself; the rest sleep until it hands polling over or finds more
+            // than it can take on alone
+            if (pool.isPolling(index))
+            {
+                wait(interval);
+                interval = juce::jmin(2 * interval, maxPollInterval);
+            }
+            else
+            {
+                wait(-1);
+                interval = pollInterval;
+            }
+        }
+    }
+
+private:
+    WorkerPool &pool;
+    const int index;
+};
+
+//==============================================================================
+std::shared_ptr<WorkerPool> WorkerPool::getShared()
+{
+    static std::mutex lock;
+    static std::weak_ptr<WorkerPool> shared;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (auto existing = shared.lock())
+        return existing;
+
+    std::shared_ptr<WorkerPool> pool(new WorkerPool());
+    shared = pool;
+    return pool;
+}
+
+WorkerPool::WorkerPool()
+{
+    auto numThreads = juce::jlimit(1, maxThreads, juce::SystemStats::getNumCpus() / 2);
+
+    for (int i = 0; i < numThreads; ++i)
+        workers.push_back(std::make_unique<Worker>(*this, i));
+    workerBusy.assign((size_t) numThreads, false);
+
+    for (auto &worker : workers)
+        worker->startThread();
+}
+
+WorkerPool::~WorkerPool()
+{
+    jassert(jobs.empty()); // every job holds the pool, so they've all been removed by now
+
+    for (auto &worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (auto &worker : workers)
+        worker->stopThread(2000);
+}
+
+void WorkerPool::add(Job &job)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    jassert(std::find(jobs.begin(), jobs.end(), &job) == jobs.end());
+
+    job.cancelled.store(false, std::memory_order_relaxed);
+    jobs.push_back(&job);
+}
+
+void WorkerPool::remove(Job &job)
+{
+    job.cancelled.store(true, std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> guard(lock);
+    jobFinished.wait(guard, [&job] { return !job.running; });
+
+    jobs.erase(std::remove(jobs.begin(), jobs.end(), &job), jobs.end());
+    job.requested.store(0, std::memory_order_relaxed);
+}
+
+WorkerPool::Job* WorkerPool::claim(int workerIndex)
+{
+    Job *best = nullptr;
+    auto bestRequest = 0, numWaiting = 0, newPoller = -1;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        auto numJobs = jobs.size();
+        for (size_t i = 0; i < numJobs; ++i)
+        {
+            auto *job = jobs[(nextScan + i) % numJobs];
+            auto request = job->requested.load(std::memory_order_acquire);
+            if (request == 0 || job->running)
+                continue;
+
+            ++numWaiting;
+            if (best == nullptr || request < bestRequest)
+            {
+                best = job;
+                bestRequest = request;
+            }
+        }
+
+        if (best == nullptr)
+            return nullptr;
+
+        // A request arriving from here on sets this again, and the job runs once more after this run
+        best->requested.exchange(0, std::memory_order_acquire);
+        best->running = true;
+        nextScan = numJobs > 0 ? (nextScan + 1) % numJobs : 0;
+        workerBusy[(size_t) workerIndex] = true;
+
+        // The job may be long, so polling goes to an idle worker for the meantime
+        if (pollingWorker.load(std::memory_order_relaxed) == workerIndex)
+        {
+            for (int i = 0; i < (int) workerBusy.size() && newPoller < 0; ++i)
+                if (!workerBusy[(size_t) i])
+                    newPoller = i;
+
+            pollingWorker.store(newPoller, std::memory_order_release);
+        }
+    }
+
+    if (numWaiting > 1)
+    {
+        for (auto &worker : workers)
+            worker->notify();
+    }
+    else if (newPoller >= 0)
+    {
+        workers[(size_t) newPoller]->notify();
+    }
+
+    return best;
+}
+
+void WorkerPool::finish(Job &job, int workerIndex)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        job.running = false;
+        workerBusy[(size_t) workerIndex] = false;
+
+        if (pollingWorker.load(std::memory_order_relaxed) < 0) // every worker was busy, so nobody was polling
+            pollingWorker.store(workerIndex, std::memory_order_release);
+    }
+
+    jobFinished.notify_all();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "FilterChain.h"
+
+//==============================================================================
+/**
+    Background threads shared by every FiltEQ in the process, for work that mustn't run on the audio thread and
+    doesn't need a thread of its own: building coefficient tables, feedback analysis, writing the diagnostic log,
+    the editor's response curve.
+
+    Work comes as Jobs that stay registered with the pool for as long as their owner lives. Asking for a run is a
+    couple of atomic operations that never wait or allocate, so it's fine from an audio thread, and a job that is
+    already waiting isn't queued again: any number of requests before it starts collapse into one run, at the most
+    urgent priority asked for. A request that arrives while the job is running gets it one more run afterwards. A job
+    never runs on two threads at once.
+
+    Nothing wakes a worker from the audio thread (that would mean taking a lock), so one idle worker polls for new
+    requests and wakes the others when there's more than it can take on its own. It polls every pollInterval
+    milliseconds, backing off to maxPollInterval while nothing comes. Before it runs a job it hands polling to
+    another idle worker, so a request made while a long job runs is still picked up within pollInterval; only with
+    every worker busy does it wait, and then the first to finish takes polling back up.
+    There are half as many workers as cores, between 1 and maxThreads, however many instances are loaded.
+*/
+class WorkerPool
+{
+public:
+    enum class Priority
+    {
+        high,   // latency matters: analysis feeding the audio thread
+        normal, // something is waiting on the result: tables, the editor
+        low     // housekeeping: the log
+    };
+
+    class Job
+    {
+    public:
+        virtual ~Job() = default;
+
+        // Any thread, including the audio thread
+        void schedule(Priority priority) noexcept
+        {
+            auto wanted = 1 + (int) priority;
+            auto current = requested.load(std::memory_order_relaxed);
+            while ((current == 0 || wanted < current)
+                   && !requested.compare_exchange_weak(current, wanted, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+        }
+
+    protected:
+        // Called on a worker. Long jobs should return early once isCancelled() is true.
+        virtual void run() = 0;
+        bool isCancelled() const noexcept { return cancelled.load(std::memory_order_relaxed); }
+
+    private:
+        friend class WorkerPool;
+        std::atomic<int> requested {0}; // 0 when not queued, otherwise 1 + the most urgent Priority asked for
+        std::atomic<bool> cancelled {false};
+        bool running = false; // guarded by the pool's lock
+    };
+
+    static std::shared_ptr<WorkerPool> getShared();
+    ~WorkerPool();
+
+    // Not from the audio thread. remove() waits for a run in progress to finish, so call it before a job's state goes.
+    void add(Job &job);
+    void remove(Job &job);
+
+    int getNumThreads() const noexcept { return (int) workers.size(); }
+
+    static constexpr int maxThreads = 8;
+    static constexpr int pollInterval = 2, maxPollInterval = 16; // milliseconds
+
+private:
+    class Worker;
+
+    WorkerPool();
+
+    Job* claim(int workerIndex); // the most urgent queued job that isn't running, marked as running
+    void finish(Job &job, int workerIndex);
+    bool isPolling(int workerIndex) const noexcept { return pollingWorker.load(std::memory_order_acquire) == workerIndex; }
+
+    std::mutex lock;
+    std::condition_variable jobFinished;
+    std::vector<Job*> jobs;
+    size_t nextScan = 0; // where the next search starts, so jobs of equal priority take turns
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<bool> workerBusy; // guarded by lock
+    std::atomic<int> pollingWorker {0}; // -1 while every worker is running a job; only changed under lock
+};
@@ -113,19 +113,21 @@ juce::Rectangle<int> RotarySliderWithLabels::getSliderBounds() const
 }
 
 
-ResponseCurveComponent::ResponseCurveComponent(FiltEQAudioProcessor& p) : audioProcessor(p)
+ResponseCurveComponent::ResponseCurveComponent(FiltEQAudioProcessor& p) : audioProcessor(p), pool(WorkerPool::getShared())
 {
     const auto& params = audioProcessor.getParameters();
     for (auto param : params)
     {
         param->addListener(this);
     }
-    updateChain();
+    pool->add(*this);
     startTimerHz(60);
 }
 
 ResponseCurveComponent::~ResponseCurveComponent()
 {
+    pool->remove(*this);
+    
     const auto& params = audioProcessor.getParameters();
     for (auto param : params)
     {
@@ -141,80 +143,83 @@ void ResponseCurveComponent::parameterValueChanged (int parameterIndex, float ne
 
 void ResponseCurveComponent::timerCallback()
 {
-    if (parametersChanged.compareAndSetBool(false, true))
+    bool changed;
     {
-        updateChain();
-        repaint();
+        std::lock_guard<std::mutex> guard(curveLock);
+        changed = curveChanged;
+        curveChanged = false;
+        
+        // Until the processor is prepared and the component laid out there's nothing to draw, and run() would drop
+        // the request, so the flag stays set until then
+        auto sampleRate = audioProcessor.getSampleRate();
+        if (sampleRate > 0 && getWidth() > 0 && parametersChanged.compareAndSetBool(false, true))
+        {
+            requestedSettings = getChainSettings(audioProcessor.apvts);
+            requestedSampleRate = sampleRate;
+            requestedWidth = getWidth();
+            schedule(WorkerPool::Priority::normal);
+        }
     }
+    
+    if (changed)
+        repaint();
 }
 
-void ResponseCurveComponent::updateChain()
+void ResponseCurveComponent::resized()
 {
-    auto chainSettings = getChainSettings(audioProcessor.apvts);
-    auto peakCoefficients = makePeakFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    
-    auto midCoefficients = makeMidFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficients(monoChain.get<ChainPositions::Mid>().coefficients, midCoefficients);
-    
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCutFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+    parametersChanged.set(true);
 }
 
-void ResponseCurveComponent::paint (juce::Graphics& g)
+void ResponseCurveComponent::run()
 {
-    using namespace juce;
-    
-    g.fillAll (juce::Colour (0xff041e29));
-    
-    auto responseArea = getLocalBounds();
-    auto w = responseArea.getWidth();
+    ChainSettings chainSettings;
+    double sampleRate;
+    int w;
+    {
+        std::lock_guard<std::mutex> guard(curveLock);
+        chainSettings = requestedSettings;
+        sampleRate = requestedSampleRate;
+        w = requestedWidth;
+    }
     
-    auto &lowcut = monoChain.get<ChainPositions::LowCut>();
-    auto &peak = monoChain.get<ChainPositions::Peak>();
-    auto &highcut = monoChain.get<ChainPositions::HighCut>();
-    auto &mid = monoChain.get<ChainPositions::Mid>();
+    if (sampleRate <= 0 || w <= 0)
+        return;
     
-    auto sampleRate = audioProcessor.getSampleRate();
-    std::vector<double> mags;
+    BiquadCoefficients sections[maxChainSections];
+    auto numSections = makeChainBiquads(chainSettings, sampleRate, sections);
     
-    mags.resize(w);
+    std::vector<double> newMags((size_t) w);
     
     for (int i=0; i<w; ++i)
     {
-        double mag = 1.f;
-        auto freq = mapToLog10(double (i) / double(w), 20.0, 20000.0);
-        
-        if (!monoChain.isBypassed<ChainPositions::Peak>())
-            mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        
-        if (!monoChain.isBypassed<ChainPositions::Mid>())
-            mag *= mid.coefficients->getMagnitudeForFrequency(freq, sampleRate);
+        double mag = 1.0;
+        auto freq = juce::mapToLog10(double (i) / double(w), 20.0, 20000.0);
         
-        if (!lowcut.isBypassed<0>())
-            mag *= lowcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!lowcut.isBypassed<1>())
-            mag *= lowcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!lowcut.isBypassed<2>())
-            mag *= lowcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!lowcut.isBypassed<3>())
-            mag *= lowcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        
-        if (!highcut.isBypassed<0>())
-            mag *= highcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!highcut.isBypassed<1>())
-            mag *= highcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!highcut.isBypassed<2>())
-            mag *= highcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!highcut.isBypassed<3>())
-            mag *= highcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        
-        mags[i] = Decibels::gainToDecibels(mag);
+        for (int k = 0; k < numSections; ++k)
+            mag *= std::abs(getResponseForFrequency(sections[k], freq, sampleRate));
         
+        newMags[(size_t) i] = juce::Decibels::gainToDecibels(mag);
     }
     
+    std::lock_guard<std::mutex> guard(curveLock);
+    mags.swap(newMags);
+    curveChanged = true;
+}
+
+void ResponseCurveComponent::paint (juce::Graphics& g)
+{
+    using namespace juce;
+    
+    g.fillAll (juce::Colour (0xff041e29));
+    
+    auto responseArea = getLocalBounds();
+    g.setColour (juce::Colour (0xff0b5574));
+    g.drawRoundedRectangle(responseArea.toFloat(), 4.f, 1.f);
+    
+    std::lock_guard<std::mutex> guard(curveLock);
+    if (mags.empty())
+        return; // the first curve is still being computed
+    
     Path responseCurve;
     
     const double outputMin = responseArea.getBottom();
@@ -231,8 +236,6 @@ void ResponseCurveComponent::paint (juce::Graphics& g)
         responseCurve.lineTo(responseArea.getX()+i, map(mags[i]));
     }
     
-    g.setColour (juce::Colour (0xff0b5574));
-    g.drawRoundedRectangle(responseArea.toFloat(), 4.f, 1.f);
     g.setColour(Colours::cyan);
     g.strokePath(responseCurve, PathStrokeType(2.f));
 }
@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "DSP/WorkerPool.h"
 
 struct LookAndFeel : juce::LookAndFeel_V4
 {
@@ -51,7 +52,8 @@ private:
 
 struct ResponseCurveComponent: juce::Component,
 juce::AudioProcessorParameter::Listener,
-juce::Timer
+juce::Timer,
+private WorkerPool::Job
 {
     ResponseCurveComponent(FiltEQAudioProcessor&);
     ~ResponseCurveComponent();
@@ -59,12 +61,21 @@ juce::Timer
     void parameterGestureChanged (int parameterIndex, bool gestureIsStarting) override {};
     void timerCallback() override;
     void paint(juce::Graphics &g) override;
+    void resized() override;
     
 private:
+    void run() override; // computes the curve on a worker, so dragging a slider never waits on it
+    
     FiltEQAudioProcessor& audioProcessor;
-    juce::Atomic<bool> parametersChanged {false};
-    MonoChain monoChain;
-    void updateChain();
+    juce::Atomic<bool> parametersChanged {true};
+    std::shared_ptr<WorkerPool> pool;
+    
+    std::mutex curveLock; // guards everything below
+    ChainSettings requestedSettings;
+    double requestedSampleRate = 0;
+    int requestedWidth = 0;
+    std::vector<double> mags; // dB per pixel
+    bool curveChanged = false;
 };
 
 //==============================================================================
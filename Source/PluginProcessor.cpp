@@ -10,14 +10,33 @@ FiltEQAudioProcessor::FiltEQAudioProcessor()
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                       .withOutput ("Band 2", juce::AudioChannelSet::stereo(), false) // crossover bands, for hosts that enable them
+                       .withOutput ("Band 3", juce::AudioChannelSet::stereo(), false)
+                       .withOutput ("Band 4", juce::AudioChannelSet::stereo(), false)
                      #endif
                        )
 #endif
 {
+    for (int i = 0; i < LinkGroup::numParameters; ++i)
+        apvts.addParameterListener(LinkGroup::getParameterId(i), this);
+    
+    for (int i = 0; i < Crossover::maxBands - 1; ++i)
+        crossoverFrequencyParameters[i] = apvts.getRawParameterValue("Crossover Freq " + juce::String(i + 1));
+    for (int band = 1; band < Crossover::maxBands; ++band)
+        bandCorrectionParameters[band].attach(apvts, band);
+    
+    startTimerHz(30); // joins, leaves and group edits reach apvts (and so the editor) from here, latency changes the host
 }
 
 FiltEQAudioProcessor::~FiltEQAudioProcessor()
 {
+    stopTimer();
+    
+    for (int i = 0; i < LinkGroup::numParameters; ++i)
+        apvts.removeParameterListener(LinkGroup::getParameterId(i), this);
+    
+    if (joinedGroup != nullptr)
+        joinedGroup->leave();
 }
 
 //==============================================================================
@@ -92,10 +111,83 @@ void FiltEQAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock
     spec.numChannels = 1;
     spec.sampleRate = sampleRate;
     
-    leftChannel.prepare(spec);
-    rightChannel.prepare(spec);
+    for (auto &chain : leftChannels)
+        chain.prepare(spec);
+    for (auto &chain : rightChannels)
+        chain.prepare(spec);
+    for (auto &chain : midSideChains)
+        chain.reset();
+    
+    transition.prepare({sampleRate, (juce::uint32) samplesPerBlock, 2});
+    coefficientTable = CoefficientTable::getFor(sampleRate);
+    liveChain = 0;
+    
+    leftLowBand.prepare(sampleRate);
+    rightLowBand.prepare(sampleRate);
+    lowBandEngaged = lowBandLive = lowBandToggled = false;
+    chainMovedBands[0] = chainMovedBands[1] = {};
+    
+    modulator.prepare(sampleRate, samplesPerBlock);
+    for (auto *band : { &leftPeakBand, &rightPeakBand, &leftMidBand, &rightMidBand })
+        band->prepare(sampleRate);
+    for (auto *band : { &leftPeakSaturation, &rightPeakSaturation, &leftMidSaturation, &rightMidSaturation })
+        band->prepare(sampleRate);
+    peakSaturated = midSaturated = bandsHandingOver = false;
+    
+    feedbackSuppressor.prepare(sampleRate, samplesPerBlock);
+    feedbackActive = false;
+    
+    resonanceSuppressor.prepare(sampleRate); // every FFT size, so switching sizes later doesn't allocate
+    resonanceActive = false;
+    
+    leftCrossover.prepare(sampleRate);
+    rightCrossover.prepare(sampleRate);
+    crossoverScratch.setSize(2 * (Crossover::maxBands - 1), samplesPerBlock);
+    crossoverActive = false;
+    midSideActive = midSideLive = false; // the first block switches to mid/side if it's on, crossfading as it does
     
     updateFilters();
+    updateCrossover(liveSettings);
+    updateModulation(liveSettings);
+    updateSaturation(liveSettings);
+    updateRouting(liveSettings);
+    updateResonanceSuppression();
+    
+    // Nothing has played yet, so the low band and the bands run outside the chains start as they're set instead of
+    // crossfading in on the first block
+    lowBandLive = lowBandEngaged;
+    lowBandToggled = false;
+    chainMovedBands[liveChain] = chainMovedBands[1 - liveChain];
+    for (auto *band : { &leftPeakBand, &rightPeakBand, &leftMidBand, &rightMidBand })
+        band->finishFade();
+    for (auto *band : { &leftPeakSaturation, &rightPeakSaturation, &leftMidSaturation, &rightMidSaturation })
+        band->finishFade();
+    bandsHandingOver = false;
+    peakRouted[liveChain] = peakRouted[1 - liveChain];
+    midRouted[liveChain] = midRouted[1 - liveChain];
+    updateBypass(liveChain);
+    
+    publishLatency();
+    updateLatency();
+    
+    // The cached chains are always ready, and the file is opened here if a bounce is being prepared, or by the timer
+    // if the host only switches to non-realtime later
+    cachedPathLive = cachedPathIncoming = false;
+    {
+        const juce::ScopedLock lock(renderCacheLock);
+        renderCacheOpen = false;
+        renderCacheTried = false;
+        renderCache.close();
+        
+        leftCached.prepare(sampleRate, 1);
+        rightCached.prepare(sampleRate, 1);
+        leftCached.setSettings(liveSettings);
+        rightCached.setSettings(liveSettings);
+        cachedSettings = liveSettings;
+        cacheState.assign((size_t) (leftCached.getStateSize() + rightCached.getStateSize()), 0.f);
+        renderCacheBlockSize = samplesPerBlock;
+    }
+    openRenderCache();
 }
 
 void FiltEQAudioProcessor::releaseResources()
@@ -125,6 +217,11 @@ bool FiltEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) c
         return false;
    #endif
 
+    // The crossover band outputs are either off or match the main output
+    for (int bus = 1; bus < layouts.outputBuses.size(); ++bus)
+        if (!layouts.outputBuses[bus].isDisabled() && layouts.outputBuses[bus] != layouts.getMainOutputChannelSet())
+            return false;
+
     return true;
   #endif
 }
@@ -133,6 +230,9 @@ bool FiltEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) c
 void FiltEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+   #if FILTEQ_REALTIME_LOG
+    auto blockStart = juce::Time::getHighResolutionTicks();
+   #endif
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -145,7 +245,35 @@ void FiltEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce:
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
-    updateFilters();
+    auto chainSettings = getChainSettings(apvts);
+    linkedDesign = false;
+    if (auto *group = linkGroup.load(std::memory_order_acquire))
+    {
+        // The group's design is used whole, settings included, so this block's chains all agree with each other
+        linkedDesign = group->getSnapshot(getSampleRate(), linkSnapshot);
+        chainSettings = linkedDesign ? linkSnapshot.settings : getChainSettings(*group);
+    }
+    
+    updateCrossover(chainSettings);
+    updateMidSide();
+    updateModulation(chainSettings);
+    updateSaturation(chainSettings);
+    updateRouting(chainSettings);
+    updateFeedbackSuppression();
+    updateResonanceSuppression();
+    publishLatency();
+    
+    // Only for offline blocks, checked every block since hosts can switch back to realtime without preparing again.
+    // Modulation, saturation, the multirate low band, feedback notches, resonance suppression, the crossover and
+    // mid/side aren't part of the cached chains, so with any of them on the MonoChains take over again.
+    auto cacheWanted = isNonRealtime() && renderCacheOpen.load(std::memory_order_acquire) && apvts.getRawParameterValue("Render Cache")->load() > 0.5f
+                    && !peakModulated && !midModulated && !peakSaturated && !midSaturated && !lowBandWanted
+                    && !lowBandLive && !feedbackActive && !resonanceActive && !crossoverActive && !midSideWanted;
+    
+    auto &liveLeft = leftChannels[liveChain];
+    auto &liveRight = rightChannels[liveChain];
+    auto &incomingLeft = leftChannels[1 - liveChain];
+    auto &incomingRight = rightChannels[1 - liveChain];
         
     // Here we take our audio buffer, split it into channels, wrap it in an ProcessingContext which we can then ask our chains to process
     juce::dsp::AudioBlock<float> block(buffer); // Create Audio Block from buffer
@@ -153,12 +281,250 @@ void FiltEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce:
     auto leftBlock = block.getSingleChannelBlock(0);
     auto rightBlock = block.getSingleChannelBlock(1);
     
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    auto presetArrived = !transition.isActive() && presetLoaded.exchange(false); // one arriving mid-fade waits for the fade to end
+    planFilters(chainSettings);
+    
+    auto sameMerges = midSideActive ? plannedMidSide.canSwitchInPlace(midSidePlans[liveChain])
+                                    : plannedChain.hasSameMerges(chainPlans[liveChain]);
+    
+    if (transition.isActive())
+    {
+        updateFilters(chainSettings, 1 - liveChain); // the live chains stay on the old settings until the fade is over
+        if (cachedPathIncoming)
+            updateCachedChains(chainSettings);
+        else if (cachedPathLive)
+            updateCachedChains(liveSettings); // only to follow what the live pair runs outside
+    }
+    else if (presetArrived
+             || chainSettings.lowCutSlope != liveSettings.lowCutSlope
+             || chainSettings.highCutSlope != liveSettings.highCutSlope
+             || !sameMerges // the state of merged (or in mid/side, moved) sections stood for a different signal
+             || lowBandToggled // bands moving to or from the low band, which fades in or out with them
+             || bandsHandingOver // Peak/Mid moving between the chains and their own processors, which fade in step
+             || cacheWanted != cachedPathLive // handing over to or back from the cached chains
+             || midSideSwitched) // from one mode's chains to the other's
+    {
+        FILTEQ_LOG(realtimeLog, presetArrived ? RealtimeLog::Event::presetApplied : RealtimeLog::Event::transitionStarted,
+                   (float) liveSettings.lowCutSlope, (float) chainSettings.lowCutSlope, (float) liveSettings.highCutSlope, (float) chainSettings.highCutSlope);
+        
+        // Slope changes un-bypass stages holding stale state and presets swap everything at once, so crossfade to a fresh chain instead.
+        // A change while the cached chains are heard goes to the MonoChains, and the next block hands back to the cache,
+        // as it does after leaving mid/side.
+        updateFilters(chainSettings, 1 - liveChain);
+        cachedPathIncoming = cacheWanted && !cachedPathLive && !midSideSwitched;
+        if (midSideActive)
+        {
+            transition.prewarmStereo(midSideChains[1 - liveChain]);
+        }
+        else if (cachedPathIncoming)
+        {
+            updateCachedChains(chainSettings);
+            transition.prewarm(leftCached, 0);
+            transition.prewarm(rightCached, 1);
+        }
+        else if (lowBandEngaged && !lowBandLive) // the low band comes in with the incoming chains, warmed up with them
+        {
+            LowBandChain<MonoChain> incomingLeftLowBand { incomingLeft, leftLowBand }, incomingRightLowBand { incomingRight, rightLowBand };
+            transition.prewarm(incomingLeftLowBand, 0);
+            transition.prewarm(incomingRightLowBand, 1);
+        }
+        else
+        {
+            transition.prewarm(incomingLeft, 0);
+            transition.prewarm(incomingRight, 1);
+        }
+        transition.start();
+    }
+    else
+    {
+        updateFilters(chainSettings, liveChain);
+        if (cachedPathLive)
+            updateCachedChains(chainSettings);
+        liveSettings = chainSettings;
+    }
+    
+   #if FILTEQ_REALTIME_LOG
+    if (chainSettings != loggedSettings) // only designs that changed need checking
+    {
+        logUnstableSections(transition.isActive() ? incomingLeft : liveLeft);
+        loggedSettings = chainSettings;
+    }
+   #endif
+    
+    transition.recordInput(leftBlock, 0);
+    transition.recordInput(rightBlock, 1);
+    
+    auto lowBandAfterChains = lowBandLive && lowBandEngaged; // otherwise it's on one side of the fade, or off
+    
+    if (transition.isActive())
+    {
+        if (midSideLive || midSideActive)
+        {
+            StereoChainPair<MonoChain> liveLeftRight { liveLeft, liveRight }, incomingLeftRight { incomingLeft, incomingRight };
+            
+            if (midSideLive && midSideActive)
+                transition.processStereo(midSideChains[liveChain], midSideChains[1 - liveChain], leftBlock, rightBlock);
+            else if (midSideLive)
+                transition.processStereo(midSideChains[liveChain], incomingLeftRight, leftBlock, rightBlock);
+            else
+                transition.processStereo(liveLeftRight, midSideChains[1 - liveChain], leftBlock, rightBlock);
+        }
+        else if (cachedPathIncoming)
+        {
+            transition.process(liveLeft, leftCached, leftBlock);
+            transition.process(liveRight, rightCached, rightBlock);
+        }
+        else if (cachedPathLive)
+        {
+            transition.process(leftCached, incomingLeft, leftBlock);
+            transition.process(rightCached, incomingRight, rightBlock);
+        }
+        else if (lowBandLive && !lowBandEngaged)
+        {
+            LowBandChain<MonoChain> liveLeftLowBand { liveLeft, leftLowBand }, liveRightLowBand { liveRight, rightLowBand };
+            transition.process(liveLeftLowBand, incomingLeft, leftBlock);
+            transition.process(liveRightLowBand, incomingRight, rightBlock);
+        }
+        else if (lowBandEngaged && !lowBandLive)
+        {
+            LowBandChain<MonoChain> incomingLeftLowBand { incomingLeft, leftLowBand }, incomingRightLowBand { incomingRight, rightLowBand };
+            transition.process(liveLeft, incomingLeftLowBand, leftBlock);
+            transition.process(liveRight, incomingRightLowBand, rightBlock);
+        }
+        else
+        {
+            transition.process(liveLeft, incomingLeft, leftBlock);
+            transition.process(liveRight, incomingRight, rightBlock);
+        }
+        transition.advance(buffer.getNumSamples());
+        
+        if (!transition.isActive()) // fade finished, the incoming chains are now the ones heard
+        {
+            if (!cachedPathIncoming)
+                liveChain = 1 - liveChain; // the cached chains stand in for the live pair, which stays where it is
+            
+            cachedPathLive = cachedPathIncoming;
+            cachedPathIncoming = false;
+            midSideLive = midSideActive;
+            lowBandLive = lowBandEngaged;
+            bandsHandingOver = false;
+            liveSettings = chainSettings;
+        }
+    }
+    else if (midSideActive)
+    {
+        midSideChains[liveChain].process(leftBlock.getChannelPointer(0), rightBlock.getChannelPointer(0), buffer.getNumSamples());
+    }
+    else if (cachedPathLive)
+    {
+        processCached(buffer);
+    }
+    else
+    {
+        juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
+        juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+        
+        liveLeft.process(leftContext);
+        liveRight.process(rightContext);
+    }
+    
+    auto peakModulationRunning = peakModulated || leftPeakBand.isFading(); // still heard while fading out
+    auto midModulationRunning = midModulated || leftMidBand.isFading();
+    
+    if (peakModulationRunning || midModulationRunning)
+    {
+        // The modulator's buffer only covers the prepared block size, and hosts are allowed to send more
+        auto numSamples = buffer.getNumSamples();
+        auto chunkSize = modulator.getMaximumBlockSize();
+        
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            auto length = juce::jmin(chunkSize, numSamples - start);
+            modulator.generate(block.getSubBlock((size_t) start, (size_t) length)); // the envelope follows the signal as it reaches the bands
+            
+            auto *left = leftBlock.getChannelPointer(0) + start;
+            auto *right = rightBlock.getChannelPointer(0) + start;
+            
+            if (peakModulationRunning)
+            {
+                leftPeakBand.process(left, modulator.getOffsets(), length);
+                rightPeakBand.process(right, modulator.getOffsets(), length);
+            }
+            if (midModulationRunning)
+            {
+                leftMidBand.process(left, modulator.getOffsets(), length);
+                rightMidBand.process(right, modulator.getOffsets(), length);
+            }
+        }
+    }
     
-    leftChannel.process(leftContext);
-    rightChannel.process(rightContext);
+    if (peakSaturated || leftPeakSaturation.isFading())
+    {
+        leftPeakSaturation.process(leftBlock.getChannelPointer(0), buffer.getNumSamples());
+        rightPeakSaturation.process(rightBlock.getChannelPointer(0), buffer.getNumSamples());
+    }
+    if (midSaturated || leftMidSaturation.isFading())
+    {
+        leftMidSaturation.process(leftBlock.getChannelPointer(0), buffer.getNumSamples());
+        rightMidSaturation.process(rightBlock.getChannelPointer(0), buffer.getNumSamples());
+    }
+    
+    if (lowBandAfterChains)
+    {
+        leftLowBand.process(leftBlock.getChannelPointer(0), buffer.getNumSamples());
+        rightLowBand.process(rightBlock.getChannelPointer(0), buffer.getNumSamples());
+    }
+    
+    if (resonanceSuppressor.isRunning())
+        resonanceSuppressor.process(leftBlock.getChannelPointer(0), rightBlock.getChannelPointer(0), buffer.getNumSamples());
+    
+    if (feedbackActive)
+        feedbackSuppressor.process(leftBlock.getChannelPointer(0), rightBlock.getChannelPointer(0), buffer.getNumSamples());
+    
+    if (crossoverActive)
+        processCrossover(buffer);
+    
+   #if FILTEQ_REALTIME_LOG
+    // An unstable section or a NaN fed in shows up in the last sample within a block or two, so that's all this checks
+    auto numSamples = buffer.getNumSamples();
+    for (int channel = 0; channel < 2 && numSamples > 0; ++channel)
+        if (!std::isfinite(buffer.getSample(channel, numSamples - 1)))
+            FILTEQ_LOG(realtimeLog, RealtimeLog::Event::nonFiniteOutput, (float) channel, (float) numSamples);
+    
+    auto microseconds = 1.0e6 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - blockStart);
+    auto budget = 1.0e6 * numSamples / getSampleRate();
+    if (microseconds > budget && !isNonRealtime())
+        FILTEQ_LOG(realtimeLog, RealtimeLog::Event::blockOverrun, (float) microseconds, (float) budget, (float) numSamples);
+   #endif
+}
+
+#if FILTEQ_REALTIME_LOG
+void FiltEQAudioProcessor::logUnstableSections(MonoChain &chain)
+{
+    // Stability triangle on the coefficients as loaded (normalised, so b0 b1 b2 a1 a2): |a2| < 1 and |a1| < 1 + a2
+    auto check = [this](const Filter &filter, int section)
+    {
+        if (filter.coefficients == nullptr || filter.coefficients->getFilterOrder() != 2)
+            return;
+        
+        const auto *c = filter.coefficients->coefficients.begin();
+        auto a1 = c[3], a2 = c[4];
+        if (!(std::abs(a2) < 1.f && std::abs(a1) < 1.f + a2))
+            FILTEQ_LOG(realtimeLog, RealtimeLog::Event::unstableDesign, (float) section, a1, a2, (float) getSampleRate());
+    };
+    
+    auto &lowCut = chain.get<ChainPositions::LowCut>();
+    auto &highCut = chain.get<ChainPositions::HighCut>();
+    
+    for (int stage = 0; stage < maxCutSections; ++stage)
+    {
+        check(lowCut.getStage(stage), stage);
+        check(highCut.getStage(stage), maxCutSections + 1 + stage);
+    }
+    check(chain.get<ChainPositions::Peak>(), maxCutSections);
+    check(chain.get<ChainPositions::Mid>(), 2 * maxCutSections + 1);
 }
+#endif
 
 //==============================================================================
 bool FiltEQAudioProcessor::hasEditor() const
@@ -184,8 +550,29 @@ void FiltEQAudioProcessor::setStateInformation (const void* data, int sizeInByte
     auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
     if (tree.isValid())
     {
+        // States saved while the slope parameters had all eight slopes hold 60 to 96 dB/Oct as choices 4 to 7, which
+        // are now the 12 to 48 choice with the Steep switch on
+        for (auto *cut : { "Low Cut", "High Cut" })
+        {
+            auto slope = tree.getChildWithProperty("id", juce::String(cut) + " Slope");
+            auto choice = (int) slope.getProperty("value", 0);
+            if (!slope.isValid() || choice < numSlopeChoices)
+                continue;
+            
+            slope.setProperty("value", choice - numSlopeChoices, nullptr);
+            
+            auto steep = tree.getChildWithProperty("id", juce::String(cut) + " Steep");
+            if (!steep.isValid())
+            {
+                steep = juce::ValueTree("PARAM");
+                steep.setProperty("id", juce::String(cut) + " Steep", nullptr);
+                tree.appendChild(steep, nullptr);
+            }
+            steep.setProperty("value", 1.f, nullptr);
+        }
+        
         apvts.replaceState(tree);
-        updateFilters();
+        presetLoaded = true; // the audio thread crossfades to the new settings rather than having its coefficients swapped under it
     }
 }
 
@@ -196,111 +583,516 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
     return new FiltEQAudioProcessor();
 }
 
-// AudioParameterFloat represents parameters with a continuous knob/slider
+void FiltEQAudioProcessor::planFilters(const ChainSettings &chainSettings)
+{
+    // Most blocks change nothing, and planning a full chain is far from free (see ChainPlan), so the design and the
+    // plans are only redone for settings (or a mid/side routing) other than the last ones planned
+    if (!chainPlanned || chainSettings != plannedSettings)
+    {
+        auto numSections = getNumCutSections(chainSettings.lowCutSlope) + getNumCutSections(chainSettings.highCutSlope) + 2;
+        
+        if (linkedDesign) // designed once for the whole link group, only copied in here
+            std::copy(linkSnapshot.sections, linkSnapshot.sections + numSections, plannedSections);
+        else if (coefficientTable != nullptr && coefficientTable->isReady()) // lookups, no trig
+            coefficientTable->makeChain(chainSettings, plannedSections);
+        else
+            makeChainBiquads(chainSettings, getSampleRate(), plannedSections);
+        
+        planChain(plannedSections, numSections, plannedChain);
+        plannedSettings = chainSettings;
+        chainPlanned = true;
+        midSidePlanned = false;
+    }
+    
+    if (midSideActive && !(midSidePlanned && plannedMidSide.routing == midSideRouting))
+    {
+        planMidSide(chainSettings, plannedSections, midSideRouting, plannedMidSide);
+        midSidePlanned = true;
+    }
+}
+
+void FiltEQAudioProcessor::updateFilters(const ChainSettings &chainSettings, int chains)
+{
+    // In-place writes, no allocation once every Filter has been loaded once
+    for (auto *chain : { &leftChannels[chains], &rightChannels[chains] })
+    {
+        loadChain(*chain, chainSettings, plannedSections);
+        applyPlan(*chain, chainSettings, plannedChain, chainPlans[chains]);
+    }
+    
+    chainPlans[chains] = plannedChain;
+    peakPlanned[chains] = isPeakUsed(chainSettings, plannedChain);
+    midPlanned[chains] = isMidUsed(plannedChain);
+    updateBypass(chains);
+    
+    if (midSideActive)
+    {
+        midSideChains[chains].setPlan(plannedMidSide);
+        midSidePlans[chains] = plannedMidSide;
+    }
+}
+
+void FiltEQAudioProcessor::updateFilters()
+{
+    linkedDesign = false;
+    chainPlanned = false; // called from prepareToPlay, where the sample rate may have changed
+    liveSettings = getChainSettings(apvts);
+    planFilters(liveSettings);
+    updateFilters(liveSettings, liveChain);
+}
+
+void FiltEQAudioProcessor::updateBypass(int chains)
+{
+    // A position is off when it runs outside the chains or when the pair's plan has no use for it
+    for (auto *chain : { &leftChannels[chains], &rightChannels[chains] })
+    {
+        chain->setBypassed<ChainPositions::LowCut>(chainMovedBands[chains].lowCut);
+        chain->setBypassed<ChainPositions::Peak>(chainMovedBands[chains].peak || peakRouted[chains] || !peakPlanned[chains]);
+        chain->setBypassed<ChainPositions::Mid>(chainMovedBands[chains].mid || midRouted[chains] || !midPlanned[chains]);
+    }
+}
+
+void FiltEQAudioProcessor::updateCachedChains(const ChainSettings &chainSettings)
+{
+    // Peak and Mid run outside the chains are bypassed in the MonoChains, so they're flat here to match the pair the
+    // cached chains stand in for. That only comes up while a transition hands over, since the cached chains aren't
+    // used with any of those on.
+    auto chains = cachedPathIncoming ? 1 - liveChain : liveChain;
+    auto settings = chainSettings;
+    if (peakRouted[chains])
+        settings.peakGainInDecibels = 0.f;
+    if (midRouted[chains])
+        settings.midGainInDecibels = 0.f;
+    
+    if (settings != cachedSettings)
+    {
+        leftCached.setSettings(settings);
+        rightCached.setSettings(settings);
+        cachedSettings = settings;
+    }
+}
+
+void FiltEQAudioProcessor::processCached(juce::AudioBuffer<float>& buffer)
+{
+    auto numSamples = buffer.getNumSamples();
+    auto leftStateSize = leftCached.getStateSize();
+    float* channels[] = { buffer.getWritePointer(0), buffer.getWritePointer(1) };
+    
+    leftCached.getState(cacheState.data());
+    rightCached.getState(cacheState.data() + leftStateSize);
+    
+    RenderCache::KeyBuilder keyBuilder;
+    keyBuilder.add(cachedSettings, getSampleRate());
+    keyBuilder.add(cacheState.data(), sizeof(float) * cacheState.size());
+    keyBuilder.add(channels[0], sizeof(float) * (size_t) numSamples);
+    keyBuilder.add(channels[1], sizeof(float) * (size_t) numSamples);
+    auto key = keyBuilder.getKey();
+    
+    if (renderCache.fetch(key, channels, numSamples, cacheState.data()))
+    {
+        // The chains carry on from the state the cached block ended in, exactly as if they had processed it
+        leftCached.setState(cacheState.data());
+        rightCached.setState(cacheState.data() + leftStateSize);
+        return;
+    }
+    
+    leftCached.process(channels[0], numSamples);
+    rightCached.process(channels[1], numSamples);
+    
+    leftCached.getState(cacheState.data());
+    rightCached.getState(cacheState.data() + leftStateSize);
+    renderCache.store(key, channels, numSamples, cacheState.data());
+}
+
+void FiltEQAudioProcessor::updateModulation(const ChainSettings &chainSettings)
+{
+    auto peak = apvts.getRawParameterValue("Peak Modulation")->load() > 0.5f && !crossoverActive && !midSideActive; // the crossover has its own Peak/Mid per band, mid/side keeps them on their paths
+    auto mid = apvts.getRawParameterValue("Mid Modulation")->load() > 0.5f && !crossoverActive && !midSideActive;
+    
+    // A band moving between the chains and its SVF goes with a transition, as one moving for drive does. One switching
+    // over starts from clear integrator state rather than whatever it held from its last use.
+    if (!transition.isActive())
+    {
+        if (peak != peakModulated)
+        {
+            for (auto *band : { &leftPeakBand, &rightPeakBand })
+            {
+                if (peak)
+                    band->reset();
+                band->startFade(peak, transition.getFadeLength());
+            }
+            bandsHandingOver = true;
+        }
+        if (mid != midModulated)
+        {
+            for (auto *band : { &leftMidBand, &rightMidBand })
+            {
+                if (mid)
+                    band->reset();
+                band->startFade(mid, transition.getFadeLength());
+            }
+            bandsHandingOver = true;
+        }
+        if ((peak || mid) && !(peakModulated || midModulated))
+            modulator.reset();
+        
+        peakModulated = peak;
+        midModulated = mid;
+    }
+    
+    modulator.setSource(static_cast<BandModulator::Source>(apvts.getRawParameterValue("Modulation Source")->load()));
+    modulator.setRate(apvts.getRawParameterValue("Modulation Rate")->load());
+    modulator.setDepth(apvts.getRawParameterValue("Modulation Depth")->load());
+    
+    leftPeakBand.setBand(chainSettings.peakFreq, chainSettings.peakQuality, chainSettings.peakGainInDecibels);
+    rightPeakBand.setBand(chainSettings.peakFreq, chainSettings.peakQuality, chainSettings.peakGainInDecibels);
+    leftMidBand.setBand(chainSettings.midFreq, chainSettings.midQuality, chainSettings.midGainInDecibels);
+    rightMidBand.setBand(chainSettings.midFreq, chainSettings.midQuality, chainSettings.midGainInDecibels);
+}
 
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState &apvts) // loads the raw values of our parameters into ChainSettings which is then called later in the processBlock and prepareToPlay functions
+void FiltEQAudioProcessor::updateSaturation(const ChainSettings &chainSettings)
 {
-    ChainSettings settings;
+    // The crossover's bands have their own Peak/Mid, which don't saturate, and in mid/side mode the bands stay on their paths
+    auto peakDrive = crossoverActive || midSideActive ? 0.f : apvts.getRawParameterValue("Peak Drive")->load();
+    auto midDrive = crossoverActive || midSideActive ? 0.f : apvts.getRawParameterValue("Mid Drive")->load();
     
-    settings.lowCutFreq = apvts.getRawParameterValue("Low Cut Freq")->load();
-    settings.highCutFreq = apvts.getRawParameterValue("High Cut Freq")->load();
-    settings.peakFreq = apvts.getRawParameterValue("Peak Frequency")->load();
-    settings.peakGainInDecibels = apvts.getRawParameterValue("Peak Gain")->load();
-    settings.peakQuality = apvts.getRawParameterValue("Peak Quality")->load();
-    settings.lowCutSlope = static_cast<Slope>(apvts.getRawParameterValue("Low Cut Slope")->load());
-    settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue("High Cut Slope")->load());
-    settings.midFreq = apvts.getRawParameterValue("Mid Frequency")->load();
-    settings.midGainInDecibels = apvts.getRawParameterValue("Mid Gain")->load();
-    settings.midQuality = apvts.getRawParameterValue("Mid Quality")->load();
+    leftPeakBand.setDrive(peakDrive);
+    rightPeakBand.setDrive(peakDrive);
+    leftMidBand.setDrive(midDrive);
+    rightMidBand.setDrive(midDrive);
     
-    return settings;
+    // At zero drive the band stays in the chains, so it costs nothing extra. Moving it out and back goes with a
+    // transition, the band's share fading in or out in step with the chains' crossfade, so a change while one is
+    // already running waits for it to end. One switching over starts from clear state.
+    auto peak = peakDrive > 0.f && !peakModulated;
+    auto mid = midDrive > 0.f && !midModulated;
+    
+    if (!transition.isActive())
+    {
+        if (peak != peakSaturated)
+        {
+            for (auto *band : { &leftPeakSaturation, &rightPeakSaturation })
+            {
+                if (peak)
+                    band->reset();
+                band->startFade(peak, transition.getFadeLength());
+            }
+            bandsHandingOver = true;
+        }
+        if (mid != midSaturated)
+        {
+            for (auto *band : { &leftMidSaturation, &rightMidSaturation })
+            {
+                if (mid)
+                    band->reset();
+                band->startFade(mid, transition.getFadeLength());
+            }
+            bandsHandingOver = true;
+        }
+        
+        peakSaturated = peak;
+        midSaturated = mid;
+    }
+    
+    if (peakSaturated || leftPeakSaturation.isFading())
+    {
+        leftPeakSaturation.setBand(chainSettings.peakFreq, chainSettings.peakQuality, chainSettings.peakGainInDecibels, peakDrive);
+        rightPeakSaturation.setBand(chainSettings.peakFreq, chainSettings.peakQuality, chainSettings.peakGainInDecibels, peakDrive);
+    }
+    if (midSaturated || leftMidSaturation.isFading())
+    {
+        leftMidSaturation.setBand(chainSettings.midFreq, chainSettings.midQuality, chainSettings.midGainInDecibels, midDrive);
+        rightMidSaturation.setBand(chainSettings.midFreq, chainSettings.midQuality, chainSettings.midGainInDecibels, midDrive);
+    }
 }
 
-Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate)
+void FiltEQAudioProcessor::updateRouting(const ChainSettings &chainSettings)
 {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, chainSettings.peakFreq, chainSettings.peakQuality, juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+    lowBandWanted = apvts.getRawParameterValue("Low Band Multirate")->load() > 0.5f && leftLowBand.isAvailable() && !midSideWanted;
+    
+    // Switching crossfades the chains, with the low band on the side that has it, so one arriving mid-fade waits for the
+    // fade to end. So does one while the cached chains are heard (which this hands back from) or mid/side is, since
+    // both only crossfade mono chains without it.
+    lowBandToggled = lowBandWanted != lowBandEngaged && !transition.isActive() && !cachedPathLive && !midSideActive && !midSideLive;
+    if (lowBandToggled)
+    {
+        lowBandEngaged = lowBandWanted;
+        lowBandNeedsRouting = true;
+    }
+    
+    MultirateLowBand::Routing routing;
+    if (lowBandEngaged)
+    {
+        if (lowBandNeedsRouting || chainSettings != routedSettings) // route() is too heavy to run every block
+        {
+            lowBandRouting = leftLowBand.route(chainSettings);
+            routedSettings = chainSettings;
+            lowBandNeedsRouting = false;
+        }
+        
+        routing = lowBandRouting;
+        routing.lowCut = routing.lowCut && !midSideActive; // the low band runs on left/right
+        routing.peak = routing.peak && !peakModulated && !peakSaturated && !crossoverActive && !midSideActive; // a band run outside the chains can't also run at the reduced rate
+        routing.mid = routing.mid && !midModulated && !midSaturated && !crossoverActive && !midSideActive;
+        leftLowBand.setSections(chainSettings, routing);
+        rightLowBand.setSections(chainSettings, routing);
+    }
+    else if (!lowBandLive) // fading out, it keeps the bands it had until it's gone
+    {
+        leftLowBand.setSections(chainSettings, routing);
+        rightLowBand.setSections(chainSettings, routing);
+    }
+    
+    // Bypassed in the chains, so a transition running alongside doesn't apply a moved band twice. While the low band
+    // fades in or out, or Peak/Mid hand over to or from their own processors, the live pair keeps what it had and the
+    // incoming pair (crossfading the other way) takes the new.
+    auto holdLive = lowBandToggled || lowBandLive != lowBandEngaged || bandsHandingOver;
+    for (int chains = 0; chains < 2; ++chains)
+    {
+        if (chains != liveChain || !holdLive)
+        {
+            chainMovedBands[chains] = routing;
+            peakRouted[chains] = peakModulated || peakSaturated || crossoverActive;
+            midRouted[chains] = midModulated || midSaturated || crossoverActive;
+        }
+    }
+    
+    updateBypass(0);
+    updateBypass(1);
 }
 
-Coefficients makeMidFilter(const ChainSettings &chainSettings, double sampleRate)
+void FiltEQAudioProcessor::updateFeedbackSuppression()
 {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, chainSettings.midFreq, chainSettings.midQuality, juce::Decibels::decibelsToGain(chainSettings.midGainInDecibels));
+    auto active = apvts.getRawParameterValue("Feedback Suppression")->load() > 0.5f;
+    
+    // Notches are kept while it's on; switching it off and on again starts over with none
+    if (active && !feedbackActive)
+        feedbackSuppressor.reset();
+    feedbackActive = active;
+    
+    feedbackSuppressor.setThreshold(apvts.getRawParameterValue("Feedback Threshold")->load());
 }
 
-void FiltEQAudioProcessor::updatePeakFilter (const ChainSettings& chainSettings)
+void FiltEQAudioProcessor::updateResonanceSuppression()
 {
-//    auto peakCoefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(getSampleRate(), chainSettings.peakFreq, chainSettings.peakQuality, juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
-  
-    auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
+    auto active = apvts.getRawParameterValue("Resonance Suppression")->load() > 0.5f;
+    
+    // Sizes and overlaps come from the choices: 512 to 4096 points, and 2x, 4x or 8x
+    resonanceSuppressor.setLayout(ResonanceSuppressor::minimumOrder + (int) apvts.getRawParameterValue("Resonance FFT Size")->load(),
+                                  2 << (int) apvts.getRawParameterValue("Resonance Overlap")->load());
+    resonanceSuppressor.setThreshold(apvts.getRawParameterValue("Resonance Threshold")->load());
+    resonanceSuppressor.setDepth(apvts.getRawParameterValue("Resonance Depth")->load());
     
-    updateCoefficients(leftChannel.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    updateCoefficients(rightChannel.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+    // The suppressor fades itself in and out, and across a change of size
+    resonanceSuppressor.setEnabled(active);
+    resonanceActive = active;
 }
 
-void FiltEQAudioProcessor::updateMidFilter (const ChainSettings& chainSettings)
+void FiltEQAudioProcessor::publishLatency()
 {
-    auto midCoefficients = makeMidFilter(chainSettings, getSampleRate());
-    updateCoefficients(leftChannel.get<ChainPositions::Mid>().coefficients, midCoefficients);
-    updateCoefficients(rightChannel.get<ChainPositions::Mid>().coefficients, midCoefficients);
+    // The low band's and the suppressor's delays come and go with their fades, so they're reported from the moment
+    // they're switched (or, for the suppressor, resized)
+    latencyWanted.store((lowBandEngaged ? leftLowBand.getLatencySamples() : 0)
+                        + resonanceSuppressor.getLatencySamples(), std::memory_order_relaxed);
 }
 
-template<int Index, typename ChainType, typename CoefficientType>
-void update(ChainType &chain, const CoefficientType &coefficients)
+void FiltEQAudioProcessor::updateLatency()
 {
-    updateCoefficients(chain.template get<Index>().coefficients, coefficients[Index]);
-    chain.template setBypassed<Index>(false);
+    // prepareToPlay and the timer, never the audio thread
+    auto latency = latencyWanted.load(std::memory_order_relaxed);
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
 }
 
-template<typename ChainType, typename CoefficientType>
-void updateCutFilter(ChainType &chain, const CoefficientType &coefficients, const Slope &slope)
+void FiltEQAudioProcessor::updateCrossover(const ChainSettings &chainSettings)
 {
-    chain.template setBypassed<0>(true);
-    chain.template setBypassed<1>(true);
-    chain.template setBypassed<2>(true);
-    chain.template setBypassed<3>(true);
+    auto mode = (int) apvts.getRawParameterValue("Crossover")->load();
+    auto active = mode > 0;
+    
+    if (active && !crossoverActive)
+    {
+        leftCrossover.reset();
+        rightCrossover.reset();
+        crossoverDesigned = false; // prepareToPlay switches it off, so this also catches a new sample rate
+    }
+    crossoverActive = active;
     
-    switch (slope) {
-        case Slope_48:
-            update<3>(chain, coefficients);
-        case Slope_36:
-            update<2>(chain, coefficients);
-        case Slope_24:
-            update<1>(chain, coefficients);
-        case Slope_12:
-            update<0>(chain, coefficients);
+    if (!crossoverActive)
+        return;
+    
+    auto type = mode == 1 ? Crossover::Type::lr24 : Crossover::Type::lr48;
+    auto numBands = 2 + (int) apvts.getRawParameterValue("Crossover Bands")->load();
+    float frequencies[Crossover::maxBands - 1];
+    for (int i = 0; i < Crossover::maxBands - 1; ++i)
+        frequencies[i] = crossoverFrequencyParameters[i]->load();
+    
+    if (!crossoverDesigned || type != designedCrossoverType || numBands != designedCrossoverBands
+        || !std::equal(frequencies, frequencies + numBands - 1, designedCrossoverFrequencies))
+    {
+        leftCrossover.setSplits(type, numBands, frequencies);
+        rightCrossover.setSplits(type, numBands, frequencies);
+        
+        designedCrossoverType = type;
+        designedCrossoverBands = numBands;
+        std::copy(frequencies, frequencies + Crossover::maxBands - 1, designedCrossoverFrequencies);
+    }
+    
+    for (int band = 0; band < numBands; ++band)
+    {
+        auto correction = band == 0 ? chainSettings : bandCorrectionParameters[band].load();
+        if (!crossoverDesigned || correction != designedBandCorrections[band])
+        {
+            leftCrossover.setBandCorrection(band, correction);
+            rightCrossover.setBandCorrection(band, correction);
+            designedBandCorrections[band] = correction;
+        }
     }
+    crossoverDesigned = true;
 }
 
-void /*FiltEQAudioProcessor::*/updateCoefficients(Coefficients &old, const Coefficients &replacements)
+void FiltEQAudioProcessor::updateMidSide()
 {
-    *old = *replacements;
+    auto path = [this](const char *id) { return static_cast<MidSidePath>((int) apvts.getRawParameterValue(id)->load()); };
+    midSideRouting.lowCut = apvts.getRawParameterValue("Low Cut Path")->load() > 0.5f ? MidSidePath::side : MidSidePath::both;
+    midSideRouting.peak = path("Peak Path");
+    midSideRouting.mid = path("Mid Path");
+    
+    // The crossover splits left and right into bands, so it stays left/right. A switch arriving mid-fade waits for the
+    // fade to end, and one while the cached chains or the low band are heard waits for them to go (which this asks for).
+    midSideWanted = apvts.getRawParameterValue("Stereo Mode")->load() > 0.5f && !crossoverActive;
+    midSideSwitched = midSideWanted != midSideActive && !transition.isActive() && !cachedPathLive && !lowBandLive;
+    if (midSideSwitched)
+        midSideActive = midSideWanted; // the chains of the new mode are prewarmed and crossfaded in by processBlock
+}
+
+void FiltEQAudioProcessor::processCrossover(juce::AudioBuffer<float>& buffer)
+{
+    // The lowest band goes to the main output along with every band whose own bus the host hasn't enabled, so with
+    // only the main output the bands are summed back up (flat, apart from each band's Peak/Mid)
+    auto numBands = leftCrossover.getNumBands();
+    auto numSamples = buffer.getNumSamples();
+    auto chunkSize = crossoverScratch.getNumSamples();
+    Crossover *crossovers[] = { &leftCrossover, &rightCrossover };
+    
+    float *busChannels[Crossover::maxBands][2] = {};
+    for (int band = 1; band < numBands; ++band)
+    {
+        auto *bus = getBus(false, band);
+        if (bus != nullptr && bus->isEnabled() && bus->getNumberOfChannels() >= 2)
+        {
+            auto busBuffer = getBusBuffer(buffer, false, band);
+            busChannels[band][0] = busBuffer.getWritePointer(0);
+            busChannels[band][1] = busBuffer.getWritePointer(1);
+        }
+    }
+    
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            auto length = juce::jmin(chunkSize, numSamples - start);
+            auto *main = buffer.getWritePointer(channel, start);
+            
+            float *outputs[Crossover::maxBands] = { main };
+            for (int band = 1; band < numBands; ++band)
+                outputs[band] = busChannels[band][channel] != nullptr ? busChannels[band][channel] + start
+                                                                      : crossoverScratch.getWritePointer(channel * (Crossover::maxBands - 1) + band - 1);
+            
+            crossovers[channel]->process(main, outputs, length);
+            
+            for (int band = 1; band < numBands; ++band)
+                if (busChannels[band][channel] == nullptr)
+                    juce::FloatVectorOperations::add(main, outputs[band], length);
+        }
+    }
 }
 
-void FiltEQAudioProcessor::updateLowCutFilters(const ChainSettings &chainSettings)
+void FiltEQAudioProcessor::updateLinkGroup()
 {
-    auto cutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
-    auto &leftLowCut = leftChannel.get<ChainPositions::LowCut>();
-    auto &rightLowCut = rightChannel.get<ChainPositions::LowCut>();
-    updateCutFilter(leftLowCut, cutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(rightLowCut, cutCoefficients, chainSettings.lowCutSlope);
+    auto index = (int) apvts.getRawParameterValue("Link Group")->load();
+    auto *wanted = index > 0 ? &LinkGroup::get(index - 1) : nullptr;
+    
+    if (wanted == joinedGroup)
+        return;
+    
+    if (joinedGroup != nullptr)
+        joinedGroup->leave();
+    
+    joinedGroup = wanted;
+    
+    if (joinedGroup != nullptr)
+    {
+        seenLinkVersion = joinedGroup->getVersion();
+        
+        if (joinedGroup->join()) // the first member brings its settings, later ones take the group's
+        {
+            for (int i = 0; i < LinkGroup::numParameters; ++i)
+            {
+                auto id = LinkGroup::getParameterId(i);
+                joinedGroup->setParameter(id, apvts.getRawParameterValue(id)->load());
+            }
+        }
+        else
+        {
+            pullFromLinkGroup();
+        }
+    }
+    
+    linkGroup.store(joinedGroup, std::memory_order_release);
 }
 
-void FiltEQAudioProcessor::updateHighCutFilters(const ChainSettings &chainSettings)
+void FiltEQAudioProcessor::pullFromLinkGroup()
 {
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());
-    auto &leftHighCut = leftChannel.get<ChainPositions::HighCut>();
-    auto &rightHighCut = rightChannel.get<ChainPositions::HighCut>();
-    updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-    updateCutFilter(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+    pullingFromGroup = true;
+    
+    for (int i = 0; i < LinkGroup::numParameters; ++i)
+    {
+        auto *parameter = apvts.getParameter(LinkGroup::getParameterId(i));
+        auto value = joinedGroup->getParameter(i);
+        
+        if (parameter->convertFrom0to1(parameter->getValue()) != value)
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+    
+    pullingFromGroup = false;
 }
 
-void FiltEQAudioProcessor::updateFilters()
+void FiltEQAudioProcessor::openRenderCache()
 {
-    auto chainSettings = getChainSettings(apvts);
+    // Never the audio thread: creating and mapping the file can take a while. Once per prepareToPlay, so a file that
+    // can't be opened isn't retried on every timer tick.
+    const juce::ScopedLock lock(renderCacheLock);
+    if (renderCacheTried || renderCacheBlockSize == 0 || !isNonRealtime() || apvts.getRawParameterValue("Render Cache")->load() < 0.5f)
+        return;
     
-    updateLowCutFilters(chainSettings);
-    updatePeakFilter(chainSettings);
-    updateMidFilter(chainSettings);
-    updateHighCutFilters(chainSettings);
+    renderCacheTried = true;
+    auto cacheFile = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory).getChildFile("FiltEQ").getChildFile("RenderCache.bin");
+    renderCacheOpen.store(renderCache.open(cacheFile, (juce::int64) 256 << 20, 2, renderCacheBlockSize, (int) cacheState.size()), std::memory_order_release);
+}
+
+void FiltEQAudioProcessor::timerCallback()
+{
+    updateLatency();
+    openRenderCache();
+    updateLinkGroup();
+    
+    if (joinedGroup == nullptr)
+        return;
+    
+    auto version = joinedGroup->getVersion();
+    if (version != seenLinkVersion)
+    {
+        seenLinkVersion = version;
+        pullFromLinkGroup();
+    }
+}
+
+void FiltEQAudioProcessor::parameterChanged(const juce::String &parameterID, float newValue)
+{
+    // Edits made here, whether from the editor, host automation or a loaded preset, go to every member of the group
+    if (auto *group = linkGroup.load(std::memory_order_acquire))
+        if (!pullingFromGroup)
+            group->setParameter(parameterID, newValue);
 }
 
 // Low Cut Parameters
@@ -309,7 +1101,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout FiltEQAudioProcessor::parame
     juce::AudioProcessorValueTreeState::ParameterLayout pluginLayout; // Overall plugin Layout
     
     juce::StringArray filterCutoffChoices; // String Array Comprising of choices of how steep the filter cutoff is
-    for (int i=0; i<4; i++)
+    for (int i=0; i<numSlopeChoices; i++) // steeper slopes come from the Steep switches, so these keep their mapping
     {
         juce::String value;
         value << (12 + i*12);
@@ -331,5 +1123,74 @@ juce::AudioProcessorValueTreeState::ParameterLayout FiltEQAudioProcessor::parame
     pluginLayout.add(std::make_unique<juce::AudioParameterFloat>("Mid Gain", "Mid Gain", juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f), 0.f)); // Mid Gain
     pluginLayout.add(std::make_unique<juce::AudioParameterFloat>("Mid Quality", "Mid Quality", juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f), 1.f)); // Mid Quality
     
+    juce::StringArray modulationSources { "LFO", "Envelope" };
+    
+    pluginLayout.add(std::make_unique<juce::AudioParameterBool>("Peak Modulation", "Peak Modulation", false)); // Peak Modulation
+    pluginLayout.add(std::make_unique<juce::AudioParameterBool>("Mid Modulation", "Mid Modulation", false)); // Mid Modulation
+    pluginLayout.add(std::make_unique<juce::AudioParameterChoice>("Modulation Source", "Modulation Source", modulationSources, 0)); // Modulation Source
+    pluginLayout.add(std::make_unique<juce::AudioParameterFloat>("Modulation Rate", "Modulation Rate", juce::NormalisableRange<float>(0.01f, 1000.f, 0.01f, 0.25f), 1.f)); // LFO rate in Hz, up to audio rate
+    pluginLayout.add(std::make_unique<juce::AudioParameterFloat>("Modulation Depth", "Modulation Depth", juce::NormalisableRange<float>(-4.f, 4.f, 0.01f, 1.f), 0.f)); // Octaves
+    
+    pluginLayout.add(std::make_unique<juce::AudioParameterFloat>("Peak Drive", "Peak Drive", juce::NormalisableRange<float>(0.f, 24.f, 0.1f, 1.f), 0.f)); // dB, saturates what the Peak band adds
+    pluginLayout.add(std::make_unique<juce::AudioParameterFloat>("Mid Drive", "Mid Drive", juce::NormalisableRange<float>(0.f, 24.f, 0.1f, 1.f), 0.f)); // dB, saturates what the Mid band adds
+    
+    pluginLayout.add(std::make_unique<juce::AudioParameterBool>("Render Cache", "Render Cache", false)); // Offline bounces only
+    
+    pluginLayout.add(std::make_unique<juce::AudioParameterBool>("Low Band Multirate", "Low Band Multirate", false)); // Only takes effect at 176.4 kHz and up
+    
+    pluginLayout.add(std::make_unique<juce::AudioParameterBool>("Feedback Suppression", "Feedback Suppression", false)); // Notches growing narrow peaks, up to 16
+    pluginLayout.add(std::make_unique<juce::AudioParameterFloat>("Feedback Threshold", "Feedback Threshold", juce::NormalisableRange<float>(6.f, 30.f, 0.5f, 1.f), 15.f)); // dB a peak must stand above its surroundings
+    
+    juce::StringArray crossoverModes { "Off", "LR24", "LR48" };
+    juce::StringArray crossoverBandCounts { "2", "3", "4" };
+    const float crossoverDefaults[] = { 120.f, 1200.f, 6000.f };
+    
+    pluginLayout.add(std::make_unique<juce::AudioParameterChoice>("Crossover", "Crossover", crossoverModes, 0)); // Splits into bands on separate outputs
+    pluginLayout.add(std::make_unique<juce::AudioParameterChoice>("Crossover Bands", "Crossover Bands", crossoverBandCounts, 1)); // Crossover Bands
+    for (int i = 0; i < 3; ++i)
+    {
+        juce::String id("Crossover Freq " + juce::String(i + 1));
+        pluginLayout.add(std::make_unique<juce::AudioParameterFloat>(id, id, juce::NormalisableRange<float>(20.f, 20000.f, 0.1f, 0.3f), crossoverDefaults[i])); // Split points, sorted when applied
+    }
+    
+    // Each crossover band past the first has its own Peak/Mid, with the main ones' ranges and defaults (band 1 uses the main ones)
+    for (int band = 2; band <= 4; ++band)
+    {
+        juce::String prefix("Band " + juce::String(band) + " ");
+        pluginLayout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Peak Frequency", prefix + "Peak Frequency", juce::NormalisableRange<float>(20.f, 20000.f, 0.1f, 0.3f), 2000.f)); // Band Peak Freq
+        pluginLayout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Peak Gain", prefix + "Peak Gain", juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f), 0.f)); // Band Peak Gain
+        pluginLayout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Peak Quality", prefix + "Peak Quality", juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f), 1.f)); // Band Peak Quality
+        pluginLayout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Mid Frequency", prefix + "Mid Frequency", juce::NormalisableRange<float>(20.f, 20000.f, 0.1f, 0.3f), 1000.f)); // Band Mid Freq
+        pluginLayout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Mid Gain", prefix + "Mid Gain", juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f), 0.f)); // Band Mid Gain
+        pluginLayout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Mid Quality", prefix + "Mid Quality", juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f), 1.f)); // Band Mid Quality
+    }
+    
+    juce::StringArray linkGroups { "Off" };
+    for (int i = 1; i <= LinkGroup::numGroups; ++i)
+        linkGroups.add(juce::String(i));
+    
+    pluginLayout.add(std::make_unique<juce::AudioParameterChoice>("Link Group", "Link Group", linkGroups, 0)); // Instances in the same group share the EQ
+    
+    juce::StringArray resonanceSizes { "512", "1024", "2048", "4096" };
+    juce::StringArray resonanceOverlaps { "2x", "4x", "8x" };
+    
+    pluginLayout.add(std::make_unique<juce::AudioParameterBool>("Resonance Suppression", "Resonance Suppression", false)); // Adaptive cuts on resonances, adds latency
+    pluginLayout.add(std::make_unique<juce::AudioParameterFloat>("Resonance Threshold", "Resonance Threshold", juce::NormalisableRange<float>(0.f, 12.f, 0.1f, 1.f), 3.f)); // dB a bin must stand above its surroundings
+    pluginLayout.add(std::make_unique<juce::AudioParameterFloat>("Resonance Depth", "Resonance Depth", juce::NormalisableRange<float>(0.f, 18.f, 0.1f, 1.f), 6.f)); // Most a bin is turned down, in dB
+    pluginLayout.add(std::make_unique<juce::AudioParameterChoice>("Resonance FFT Size", "Resonance FFT Size", resonanceSizes, 1)); // Larger resolves lower and finer, with more latency
+    pluginLayout.add(std::make_unique<juce::AudioParameterChoice>("Resonance Overlap", "Resonance Overlap", resonanceOverlaps, 1)); // More follows faster, costs more
+    
+    juce::StringArray stereoModes { "Left/Right", "Mid/Side" };
+    juce::StringArray bandPaths { "Both", "Mid", "Side" }; // MidSidePath order
+    
+    pluginLayout.add(std::make_unique<juce::AudioParameterChoice>("Stereo Mode", "Stereo Mode", stereoModes, 0)); // Mid/Side filters the mid and side signals
+    pluginLayout.add(std::make_unique<juce::AudioParameterChoice>("Low Cut Path", "Low Cut Path", juce::StringArray { "Both", "Side" }, 0)); // Mid/Side mode only
+    pluginLayout.add(std::make_unique<juce::AudioParameterChoice>("Peak Path", "Peak Path", bandPaths, 0)); // Mid/Side mode only
+    pluginLayout.add(std::make_unique<juce::AudioParameterChoice>("Mid Path", "Mid Path", bandPaths, 0)); // Mid/Side mode only
+    
+    // Last, so hosts that automate by index keep every earlier parameter where it was
+    pluginLayout.add(std::make_unique<juce::AudioParameterBool>("Low Cut Steep", "Low Cut Steep", false)); // Adds 48 dB/Oct to Low Cut Slope, for 60 to 96
+    pluginLayout.add(std::make_unique<juce::AudioParameterBool>("High Cut Steep", "High Cut Steep", false)); // Adds 48 dB/Oct to High Cut Slope
+    
     return pluginLayout;
 }
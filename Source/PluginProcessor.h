@@ -1,60 +1,27 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "DSP/FilterChain.h"
+#include "DSP/ChainOptimiser.h"
+#include "DSP/ChainTransition.h"
+#include "DSP/CoefficientTable.h"
+#include "DSP/Crossover.h"
+#include "DSP/FeedbackSuppressor.h"
+#include "DSP/InterleavedChain.h"
+#include "DSP/LinkGroup.h"
+#include "DSP/MidSideChain.h"
+#include "DSP/ModulatedBand.h"
+#include "DSP/MultirateLowBand.h"
+#include "DSP/RealtimeLog.h"
+#include "DSP/RenderCache.h"
+#include "DSP/ResonanceSuppressor.h"
 
 //==============================================================================
 /**
 */
-
-enum Slope
-{
-    Slope_12, Slope_24, Slope_36, Slope_48
-};
-
-struct ChainSettings // Stores Parameter Settings
-{
-    float midFreq{0}, midGainInDecibels{0}, midQuality{1.f};
-    float peakFreq{0}, peakGainInDecibels{0}, peakQuality{1.f};
-    float lowCutFreq {0}, highCutFreq {0};
-    Slope lowCutSlope {Slope::Slope_12}, highCutSlope {Slope::Slope_12};
-};
-
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState &apvts); // used by processBlock and prepareToPlay to receive ChainSettings
-
-using Filter = juce::dsp::IIR::Filter<float>; // type namespace to avoid always having to write out nested namespaces
-using MidFilter = juce::dsp::IIR::Filter<float>;
-// The dsp namespace in JUCE works by defining a chain and passing a processing context which will run through each element of the chain automatically
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>; // Chain has 4 filters since the default one is 12db/oct and we need it to go up to 48db/oct
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter, Filter>; // Represents the layout of our EQ where we have a cut on either end and a parametric filter in the middle
-
-enum ChainPositions
-{
-    LowCut, Peak, HighCut, Mid
-};
-
-using Coefficients = Filter::CoefficientsPtr;
-void updateCoefficients(Coefficients &old, const Coefficients& replacements);
-
-Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate);
-Coefficients makeMidFilter(const ChainSettings &chainSettings, double sampleRate);
-
-template<typename ChainType, typename CoefficientType>
-void updateCutFilter(ChainType &chain, const CoefficientType &coefficients, const Slope &slope);
-
-template<int Index, typename ChainType, typename CoefficientType>
-void update(ChainType &chain, const CoefficientType &coefficients);
-
-inline auto makeLowCutFilter(const ChainSettings &chainSettings, double sampleRate)
-{
-    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq, sampleRate, 2*(chainSettings.lowCutSlope+1));
-}
-
-inline auto makeHighCutFilter(const ChainSettings &chainSettings, double sampleRate)
-{
-    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq, sampleRate, 2*(chainSettings.highCutSlope+1));
-}
-
-class FiltEQAudioProcessor  : public juce::AudioProcessor
+class FiltEQAudioProcessor  : public juce::AudioProcessor,
+                              private juce::Timer,
+                              private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     //==============================================================================
@@ -98,14 +65,137 @@ public:
     juce::AudioProcessorValueTreeState apvts {*this, nullptr, "Parameters", parameterLayoutCreation()} ; // Object that coordinates syncing of parameters between gui knobs and dsp variables
 
 private:
-    MonoChain leftChannel, rightChannel;
+    // Two chains per channel: [liveChain] is the one heard, the other is only run while a transition crossfades to it
+    MonoChain leftChannels[2], rightChannels[2];
+    int liveChain = 0;
+    
+    ChainTransition transition;
+    ChainSettings liveSettings; // settings loaded into the live chains, used to spot changes that need a transition
+    std::atomic<bool> presetLoaded {false}; // set by setStateInformation, picked up by the next processBlock
+    std::shared_ptr<CoefficientTable> coefficientTable; // shared with every instance at this sample rate, used once it's built
+    
+    // What the chains actually run: the design with flat sections dropped and cancelling ones merged away (see planChain).
+    // plannedChain is this block's, chainPlans[i] the one leftChannels[i]/rightChannels[i] were last loaded with.
+    BiquadCoefficients plannedSections[maxChainSections];
+    ChainPlan plannedChain, chainPlans[2];
+    ChainSettings plannedSettings; // what plannedSections/plannedChain were designed for
+    bool chainPlanned = false, midSidePlanned = false;
+    bool peakPlanned[2] {true, true}, midPlanned[2] {true, true}; // whether each pair's plan runs Peak/Mid at all
+    bool peakRouted[2] {}, midRouted[2] {}; // per pair, run outside the chains by modulation, drive or the crossover (updateRouting)
+    
+    // Mid/side mode: midSideChains[i] runs in place of leftChannels[i]/rightChannels[i], which are still kept loaded.
+    // Switching modes crossfades from the live chains of one mode to the other's prewarmed incoming pair.
+    // Modulation, drive and the multirate low band act on left/right, so they're off.
+    MidSideChain midSideChains[2];
+    MidSideRouting midSideRouting;
+    MidSidePlan plannedMidSide, midSidePlans[2]; // as plannedChain/chainPlans, per path
+    bool midSideActive = false, midSideSwitched = false; // the mode incoming chains run in; switched: changed this block
+    bool midSideLive = false, midSideWanted = false;     // the mode the live chains run in (differs only mid-switch), and the parameter
+    
+    // Optional at 176.4 kHz and up: bands route() finds safe to move run at a reduced rate after the chains, bypassed in them.
+    // It only runs, and its latency is only reported, while it's engaged. Switching crossfades between the chains with
+    // and without it, the low band running on its side of the fade as a LowBandChain.
+    MultirateLowBand leftLowBand, rightLowBand;
+    MultirateLowBand::Routing lowBandRouting, chainMovedBands[2]; // route()'s answer, and what each pair leaves to the low band
+    ChainSettings routedSettings; // settings lowBandRouting was worked out for
+    bool lowBandEngaged = false, lowBandNeedsRouting = true, lowBandToggled = false; // engaged: for the incoming chains; toggled: crossfade this block
+    bool lowBandLive = false, lowBandWanted = false; // in the live chains' path (differs only mid-switch), and the parameter
+    
+    // What the audio thread's current setup delays the signal by. The message thread reports it to the host, from the
+    // timer once playing, since hosts may act on a change before setLatencySamples() returns.
+    std::atomic<int> latencyWanted {0};
+    
+    // Peak/Mid with modulation on run as SVFs after the chains (bypassed in them), swept by the shared modulator
+    BandModulator modulator;
+    ModulatedBand leftPeakBand, rightPeakBand, leftMidBand, rightMidBand;
+    bool peakModulated = false, midModulated = false;
+    
+    // Peak/Mid with drive run the same way, their added band soft-saturated (a modulated band saturates inside ModulatedBand)
+    SaturatedBand leftPeakSaturation, rightPeakSaturation, leftMidSaturation, rightMidSaturation;
+    bool peakSaturated = false, midSaturated = false;
+    
+    // A band moving to or from its own processor crossfades the chains, the live pair keeping the band and the incoming
+    // one not (or the other way round), while the band's share fades in or out in step with them
+    bool bandsHandingOver = false;
     
-    void updatePeakFilter (const ChainSettings& chainSettings);
-    void updateMidFilter (const ChainSettings& chainSettings);
+    // Opt-in for offline bounces: the plain chain runs on chains whose state can be saved, so blocks seen before with the
+    // same settings and state come straight from the cache file. They stand in for the live pair, and changing over
+    // to or from them is a transition like any other, so the input history and the crossfades carry on as usual.
+    RenderCache renderCache;
+    InterleavedChain leftCached, rightCached;
+    ChainSettings cachedSettings; // as loaded, with bands run outside the chains left flat
+    std::vector<float> cacheState; // both channels' filter state
+    bool cachedPathLive = false, cachedPathIncoming = false;
     
-    void updateLowCutFilters(const ChainSettings &chainSettings);
-    void updateHighCutFilters(const ChainSettings &chainSettings);
+    // The file is opened off the audio thread, by prepareToPlay or the timer, and only once a bounce is under way with
+    // the cache on. The audio thread leaves renderCache alone until renderCacheOpen is set, and in realtime blocks.
+    std::atomic<bool> renderCacheOpen {false};
+    juce::CriticalSection renderCacheLock; // between prepareToPlay and the timer
+    bool renderCacheTried = false;
+    int renderCacheBlockSize = 0;
+    
+    // Live sound: notches placed on feedback by a background analysis, applied after everything but the crossover
+    FeedbackSuppressor feedbackSuppressor;
+    bool feedbackActive = false;
+    
+    // Adaptive cuts on whatever resonances stand out of the spectrum, after the chains and their bands. Only runs while
+    // it's on or fading out, and reports its FFT size of latency only while it's on.
+    ResonanceSuppressor resonanceSuppressor;
+    bool resonanceActive = false;
+    
+    // Crossover mode: the chains keep the low/high cut, then each channel is split into bands that carry their own
+    // Peak/Mid (the chains' are bypassed) and go to the "Band N" outputs, or are mixed into the main one
+    Crossover leftCrossover, rightCrossover;
+    juce::AudioBuffer<float> crossoverScratch; // bands without an enabled bus of their own
+    bool crossoverActive = false;
+    
+    // Their parameters are looked up once in the constructor, and the crossovers only redesigned when one of them moves
+    std::atomic<float> *crossoverFrequencyParameters[Crossover::maxBands - 1] {};
+    BandCorrectionParameters bandCorrectionParameters[Crossover::maxBands]; // [0] is unused, band 1 has the main Peak/Mid
+    Crossover::Type designedCrossoverType = Crossover::Type::lr24;
+    int designedCrossoverBands = 2;
+    bool crossoverDesigned = false; // false until the first design after the crossover is switched on
+    float designedCrossoverFrequencies[Crossover::maxBands - 1] {};
+    ChainSettings designedBandCorrections[Crossover::maxBands];
+    
+    // Link groups: instances in the same group share the EQ parameters and one coefficient design. The message thread
+    // joins and leaves and mirrors the group into apvts so editors follow; the audio thread reads the group directly
+    std::atomic<LinkGroup*> linkGroup {nullptr};
+    LinkGroup *joinedGroup = nullptr; // message thread's copy
+    juce::uint32 seenLinkVersion = 0;
+    std::atomic<bool> pullingFromGroup {false}; // apvts changes made by pullFromLinkGroup aren't sent back
+    LinkGroup::Snapshot linkSnapshot;
+    bool linkedDesign = false; // linkSnapshot holds this block's design, so planFilters copies it rather than designing
+    
+   #if FILTEQ_REALTIME_LOG
+    // Diagnostics from the audio thread, written to the log file in the background
+    RealtimeLog::Channel realtimeLog {"FiltEQ"};
+    ChainSettings loggedSettings; // last settings whose design was checked
+    void logUnstableSections(MonoChain &chain);
+   #endif
+    
+    void planFilters(const ChainSettings &chainSettings);
+    void updateFilters(const ChainSettings &chainSettings, int chains); // loads plannedChain into leftChannels[chains]/rightChannels[chains]
     void updateFilters();
+    void updateBypass(int chains);
+    void updateModulation(const ChainSettings &chainSettings);
+    void updateSaturation(const ChainSettings &chainSettings);
+    void updateRouting(const ChainSettings &chainSettings);
+    void updateCachedChains(const ChainSettings &chainSettings);
+    void processCached(juce::AudioBuffer<float>& buffer);
+    void openRenderCache();
+    void updateFeedbackSuppression();
+    void updateResonanceSuppression();
+    void publishLatency();
+    void updateLatency();
+    void updateCrossover(const ChainSettings &chainSettings);
+    void updateMidSide();
+    void processCrossover(juce::AudioBuffer<float>& buffer);
+    void updateLinkGroup();
+    void pullFromLinkGroup();
+    
+    void timerCallback() override;
+    void parameterChanged(const juce::String &parameterID, float newValue) override;
     
     
     
@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    Fixed point engine check and benchmark: for a handful of settings, compares
+    FixedPointChain (with each noise shaping mode) against the chain run in
+    double precision, next to what the float MonoChain gets, then times both
+    engines on the same noise.
+
+    On a desktop this mostly says whether the quantisation holds up; the
+    timings only become meaningful when built for the target, where the float
+    column stands in for a soft-float or FPU build.
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include "DSP/FixedPointChain.h"
+
+namespace
+{
+    struct Options
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 64;
+        double seconds = 10.0;
+    };
+
+    struct NamedSettings
+    {
+        const char *name;
+        ChainSettings settings;
+    };
+
+    std::vector<NamedSettings> makeTestSettings()
+    {
+        std::vector<NamedSettings> list;
+        list.push_back({ "defaults", ChainSettings{} });
+
+        ChainSettings mix;
+        mix.lowCutFreq = 40.f;
+        mix.lowCutSlope = Slope_24;
+        mix.peakFreq = 3200.f;
+        mix.peakGainInDecibels = 4.5f;
+        mix.midFreq = 300.f;
+        mix.midGainInDecibels = -3.f;
+        mix.midQuality = 1.4f;
+        mix.highCutFreq = 16000.f;
+        mix.highCutSlope = Slope_12;
+        list.push_back({ "mix bus", mix });
+
+        ChainSettings steep = mix;
+        steep.lowCutSlope = Slope_48;
+        steep.highCutSlope = Slope_48;
+        list.push_back({ "48 dB/oct cuts", steep });
+
+        // Everything near DC at once: the worst case for coefficient and truncation error
+        ChainSettings low;
+        low.lowCutFreq = 20.f;
+        low.lowCutSlope = Slope_48;
+        low.peakFreq = 30.f;
+        low.peakGainInDecibels = 24.f;
+        low.peakQuality = 10.f;
+        low.midFreq = 60.f;
+        low.midGainInDecibels = -24.f;
+        low.highCutFreq = 200.f;
+        low.highCutSlope = Slope_48;
+        list.push_back({ "sub bass", low });
+
+        return list;
+    }
+
+    const char* getName(FixedPointChain::NoiseShaping shaping)
+    {
+        switch (shaping)
+        {
+            case FixedPointChain::NoiseShaping::none:        return "none";
+            case FixedPointChain::NoiseShaping::firstOrder:  return "1st order";
+            case FixedPointChain::NoiseShaping::secondOrder: return "2nd order";
+        }
+
+        return "";
+    }
+
+    // Nanoseconds per sample for each engine over the same signal, in blocks of the given size
+    std::pair<double, double> time(const ChainSettings &settings, const Options &options)
+    {
+        auto numSamples = juce::jmax(options.blockSize, juce::roundToInt(options.seconds * options.sampleRate));
+        auto numBlocks = numSamples / options.blockSize;
+
+        juce::AudioBuffer<float> source(1, 1 << 16);
+        juce::Random random(42);
+        for (int i = 0; i < source.getNumSamples(); ++i)
+            source.setSample(0, i, (random.nextFloat() * 2.f - 1.f) * 0.25f);
+
+        std::vector<juce::int32> fixedSource((size_t) source.getNumSamples());
+        for (int i = 0; i < source.getNumSamples(); ++i)
+            fixedSource[(size_t) i] = juce::roundToInt(source.getSample(0, i) * 2147483647.0);
+
+        MonoChain chain;
+        chain.prepare({ options.sampleRate, (juce::uint32) options.blockSize, 1 });
+        updateChain(chain, settings, options.sampleRate);
+
+        FixedPointChain fixedChain;
+        fixedChain.prepare();
+        fixedChain.setChainSettings(settings, options.sampleRate);
+
+        juce::AudioBuffer<float> buffer(1, options.blockSize);
+        std::vector<juce::int32> fixedBuffer((size_t) options.blockSize);
+        auto sourceBlocks = source.getNumSamples() / options.blockSize;
+
+        juce::ScopedNoDenormals noDenormals;
+
+        auto start = juce::Time::getHighResolutionTicks();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            buffer.copyFrom(0, 0, source, 0, (b % sourceBlocks) * options.blockSize, options.blockSize);
+            juce::dsp::AudioBlock<float> block(buffer);
+            juce::dsp::ProcessContextReplacing<float> context(block);
+            chain.process(context);
+        }
+        auto floatSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+        start = juce::Time::getHighResolutionTicks();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            auto *input = fixedSource.data() + (b % sourceBlocks) * options.blockSize;
+            std::copy(input, input + options.blockSize, fixedBuffer.begin());
+            fixedChain.process(fixedBuffer.data(), options.blockSize);
+        }
+        auto fixedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+        auto total = double(numBlocks * options.blockSize);
+        return { 1.0e9 * floatSeconds / total, 1.0e9 * fixedSeconds / total };
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    Options options;
+
+    if (args.containsOption("--rate"))
+        options.sampleRate = args.getValueForOption("--rate").getDoubleValue();
+    if (args.containsOption("--block"))
+        options.blockSize = juce::jmax(1, args.getValueForOption("--block").getIntValue());
+    if (args.containsOption("--seconds"))
+        options.seconds = args.getValueForOption("--seconds").getDoubleValue();
+
+    std::cout << "FiltEQ fixed point engine at " << options.sampleRate << " Hz, " << options.blockSize << " sample blocks" << std::endl << std::endl;
+
+    auto allPassed = true;
+
+    for (auto &test : makeTestSettings())
+    {
+        std::cout << test.name << std::endl;
+
+        for (auto shaping : { FixedPointChain::NoiseShaping::none, FixedPointChain::NoiseShaping::firstOrder, FixedPointChain::NoiseShaping::secondOrder })
+        {
+            auto result = FixedPointChain::validate(test.settings, options.sampleRate, shaping);
+            auto floatDecibels = juce::Decibels::gainToDecibels(result.referenceError / juce::jmax(1.0e-12, result.referencePeak), -200.0);
+
+            // Without noise shaping the low settings are expected to fall short, so only the default mode decides the exit code
+            if (shaping == FixedPointChain::NoiseShaping::firstOrder)
+                allPassed = allPassed && result.passed;
+
+            std::cout << "  noise shaping " << juce::String(getName(shaping)).paddedRight(' ', 10)
+                      << "  error " << juce::String(result.errorDecibels, 1).paddedLeft(' ', 6) << " dB"
+                      << "  (float " << juce::String(floatDecibels, 1) << " dB)"
+                      << (result.stable ? "" : "  poles adjusted")
+                      << (result.passed ? "  ok" : "  FAILED") << std::endl;
+        }
+
+        auto timings = time(test.settings, options);
+        std::cout << "  float " << juce::String(timings.first, 2) << " ns/sample, fixed point " << juce::String(timings.second, 2)
+                  << " ns/sample (" << juce::String(timings.second / timings.first, 2) << "x)" << std::endl << std::endl;
+    }
+
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,525 @@
+/*
+  ==============================================================================
+
+    Session-scale load test: runs 1, 16, 128 and 512 FiltEQ instances inside an
+    AudioProcessorGraph at realistic buffer sizes and reports total CPU, the cost
+    per instance and how often a block missed its real-time deadline.
+
+    With --console, it instead times ConsoleEngine against the same number of
+    separate MonoChains (one per channel, each with its own settings) and checks
+    that both produce the same output.
+
+    With --low-band, it times the bands MultirateLowBand takes over running at
+    the reduced rate against the same bands running at the full rate in a
+    MonoChain, at 176.4 kHz and up, and checks the outputs agree.
+
+    The graph is modelled on PluginTestHost.filtergraph (a source feeding FiltEQ
+    feeding the audio output), with one stereo source track per instance. The
+    FiltEQ state stored in the file is loaded into every instance; the processor
+    is created in-process, so no plugin scanning or GUI is involved.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/DSP/ConsoleEngine.h"
+#include "../../Source/DSP/MultirateLowBand.h"
+
+namespace
+{
+    struct Options
+    {
+        juce::File graphFile;
+        juce::Array<int> instanceCounts { 1, 16, 128, 512 };
+        juce::Array<int> bufferSizes { 64, 128, 256, 512 };
+        double sampleRate = 48000.0;
+        double seconds = 10.0;
+        juce::Array<int> consoleChannels; // --console: compare ConsoleEngine with MonoChains instead
+        bool lowBand = false;             // --low-band: compare the multirate low band with the full rate chain instead
+    };
+
+    juce::Array<int> parseList(const juce::String &text)
+    {
+        juce::Array<int> values;
+        for (auto &token : juce::StringArray::fromTokens(text, ",", ""))
+            if (token.getIntValue() > 0)
+                values.add(token.getIntValue());
+        return values;
+    }
+
+    // The host saves a plugin's state wrapped in whatever its format uses (a binary plist for AudioUnits), so look for
+    // our own ValueTree inside the blob rather than assuming the blob is it
+    juce::MemoryBlock extractFiltEQState(const juce::MemoryBlock &blob)
+    {
+        if (juce::ValueTree::readFromData(blob.getData(), blob.getSize()).isValid())
+            return blob;
+
+        const juce::String treeType("Parameters");
+        auto *bytes = static_cast<const char*>(blob.getData());
+        auto typeLength = (size_t) treeType.getNumBytesAsUTF8() + 1; // the type is written with its terminating null
+
+        for (size_t offset = 0; offset + typeLength <= blob.getSize(); ++offset)
+        {
+            if (std::memcmp(bytes + offset, treeType.toRawUTF8(), typeLength) != 0)
+                continue;
+
+            if (juce::ValueTree::readFromData(bytes + offset, blob.getSize() - offset).isValid())
+                return juce::MemoryBlock(bytes + offset, blob.getSize() - offset);
+        }
+
+        return {};
+    }
+
+    juce::MemoryBlock loadStateFromGraph(const juce::File &graphFile)
+    {
+        auto xml = juce::XmlDocument::parse(graphFile);
+        if (xml == nullptr || !xml->hasTagName("FILTERGRAPH"))
+            return {};
+
+        for (auto *filter : xml->getChildWithTagNameIterator("FILTER"))
+        {
+            auto *plugin = filter->getChildByName("PLUGIN");
+            auto *state = filter->getChildByName("STATE");
+
+            if (plugin != nullptr && state != nullptr && plugin->getStringAttribute("name") == JucePlugin_Name)
+            {
+                juce::MemoryBlock blob;
+                if (blob.fromBase64Encoding(state->getAllSubText().trim()))
+                    return extractFiltEQState(blob);
+            }
+        }
+
+        return {};
+    }
+
+    struct Result
+    {
+        double cpuLoad = 0;          // processing time / audio time for the whole graph
+        double microsPerInstance = 0; // average block time divided by the number of instances
+        double worstBlockLoad = 0;   // slowest block / deadline
+        double missRate = 0;         // fraction of blocks that took longer than their deadline
+    };
+
+    Result runConfiguration(int numInstances, int bufferSize, const Options &options, const juce::MemoryBlock &state)
+    {
+        using Graph = juce::AudioProcessorGraph;
+        using IOProcessor = Graph::AudioGraphIOProcessor;
+
+        Graph graph;
+        graph.setPlayConfigDetails(2 * numInstances, 2, options.sampleRate, bufferSize); // one stereo source track per instance
+
+        auto input = graph.addNode(std::make_unique<IOProcessor>(IOProcessor::audioInputNode));
+        auto output = graph.addNode(std::make_unique<IOProcessor>(IOProcessor::audioOutputNode));
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            auto processor = std::make_unique<FiltEQAudioProcessor>();
+            if (state.getSize() > 0)
+                processor->setStateInformation(state.getData(), (int) state.getSize());
+
+            auto node = graph.addNode(std::move(processor));
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                graph.addConnection({ { input->nodeID, 2 * i + channel }, { node->nodeID, channel } });
+                graph.addConnection({ { node->nodeID, channel }, { output->nodeID, channel } }); // the graph sums every instance into the output
+            }
+        }
+
+        graph.prepareToPlay(options.sampleRate, bufferSize);
+
+        // A few seconds of distinct noise per track, cycled through so the input isn't sitting in cache
+        const int sourceBlocks = 64;
+        juce::AudioBuffer<float> source(2 * numInstances, bufferSize * sourceBlocks);
+        juce::Random random(numInstances * 7919 + bufferSize);
+        for (int channel = 0; channel < source.getNumChannels(); ++channel)
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                source.setSample(channel, i, (random.nextFloat() * 2.f - 1.f) * 0.25f);
+
+        juce::AudioBuffer<float> buffer(2 * numInstances, bufferSize);
+        juce::MidiBuffer midi;
+
+        auto numBlocks = juce::jmax(1, juce::roundToInt(options.seconds * options.sampleRate / bufferSize));
+        auto deadline = bufferSize / options.sampleRate;
+        auto warmUpBlocks = juce::jmin(numBlocks, 32);
+
+        double totalSeconds = 0, worstSeconds = 0;
+        int misses = 0;
+
+        for (int block = -warmUpBlocks; block < numBlocks; ++block)
+        {
+            auto sourceOffset = ((block + warmUpBlocks) % sourceBlocks) * bufferSize;
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                buffer.copyFrom(channel, 0, source, channel, sourceOffset, bufferSize);
+
+            auto start = juce::Time::getHighResolutionTicks();
+            graph.processBlock(buffer, midi);
+            auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            if (block < 0)
+                continue;
+
+            totalSeconds += elapsed;
+            worstSeconds = juce::jmax(worstSeconds, elapsed);
+            if (elapsed > deadline)
+                ++misses;
+        }
+
+        graph.releaseResources();
+
+        Result result;
+        result.cpuLoad = totalSeconds / (numBlocks * deadline);
+        result.microsPerInstance = 1.0e6 * totalSeconds / numBlocks / numInstances;
+        result.worstBlockLoad = worstSeconds / deadline;
+        result.missRate = double(misses) / numBlocks;
+        return result;
+    }
+
+    //==============================================================================
+    // A console's worth of different channel strips: every band and slope in use somewhere, no two channels alike
+    ChainSettings makeConsoleChannelSettings(int channel)
+    {
+        juce::Random random(channel * 104729 + 1);
+
+        ChainSettings settings;
+        settings.lowCutFreq = 20.f + 180.f * random.nextFloat();
+        settings.lowCutSlope = static_cast<Slope>(random.nextInt(Slope_96 + 1));
+        settings.peakFreq = 200.f * std::pow(40.f, random.nextFloat());
+        settings.peakGainInDecibels = -12.f + 24.f * random.nextFloat();
+        settings.peakQuality = 0.5f + 4.f * random.nextFloat();
+        settings.midFreq = 100.f * std::pow(20.f, random.nextFloat());
+        settings.midGainInDecibels = -12.f + 24.f * random.nextFloat();
+        settings.midQuality = 0.5f + 4.f * random.nextFloat();
+        settings.highCutFreq = 8000.f + 12000.f * random.nextFloat();
+        settings.highCutSlope = static_cast<Slope>(random.nextInt(Slope_96 + 1));
+        return settings;
+    }
+
+    struct ConsoleResult
+    {
+        double chainSeconds = 0, engineSeconds = 0;
+        float maxError = 0;
+    };
+
+    // Both engines filter the same noise in blocks of bufferSize; each is timed on its own pass over the audio
+    ConsoleResult runConsoleComparison(int numChannels, int bufferSize, const Options &options)
+    {
+        auto numBlocks = juce::jmax(1, juce::roundToInt(options.seconds * options.sampleRate / bufferSize));
+        const int sourceBlocks = 64;
+
+        juce::AudioBuffer<float> source(numChannels, bufferSize * sourceBlocks);
+        juce::Random random(numChannels * 7919 + bufferSize);
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                source.setSample(channel, i, (random.nextFloat() * 2.f - 1.f) * 0.25f);
+
+        std::vector<MonoChain> chains((size_t) numChannels);
+        ConsoleEngine engine;
+        engine.prepare(options.sampleRate, bufferSize, numChannels);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto settings = makeConsoleChannelSettings(channel);
+            chains[(size_t) channel].prepare({ options.sampleRate, (juce::uint32) bufferSize, 1 });
+            updateChain(chains[(size_t) channel], settings, options.sampleRate);
+            engine.setChannelSettings(channel, settings);
+        }
+
+        juce::AudioBuffer<float> chainBuffer(numChannels, bufferSize), engineBuffer(numChannels, bufferSize);
+        juce::ScopedNoDenormals noDenormals;
+        ConsoleResult result;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            auto sourceOffset = (block % sourceBlocks) * bufferSize;
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                chainBuffer.copyFrom(channel, 0, source, channel, sourceOffset, bufferSize);
+                engineBuffer.copyFrom(channel, 0, source, channel, sourceOffset, bufferSize);
+            }
+
+            auto start = juce::Time::getHighResolutionTicks();
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto *samples = chainBuffer.getWritePointer(channel);
+                juce::dsp::AudioBlock<float> channelBlock(&samples, 1, (size_t) bufferSize);
+                chains[(size_t) channel].process(juce::dsp::ProcessContextReplacing<float>(channelBlock));
+            }
+            auto middle = juce::Time::getHighResolutionTicks();
+            engine.process(engineBuffer.getArrayOfWritePointers(), bufferSize);
+            auto end = juce::Time::getHighResolutionTicks();
+
+            result.chainSeconds += juce::Time::highResolutionTicksToSeconds(middle - start);
+            result.engineSeconds += juce::Time::highResolutionTicksToSeconds(end - middle);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < bufferSize; ++i)
+                    result.maxError = juce::jmax(result.maxError, std::abs(chainBuffer.getSample(channel, i) - engineBuffer.getSample(channel, i)));
+        }
+
+        return result;
+    }
+
+    // The batched engine is expected to be at least this much faster than one MonoChain per channel
+    constexpr double consoleTargetSpeedup = 4.0;
+    constexpr float consoleErrorLimit = 1.0e-3f; // the engine designs in double, FilterDesign in float
+
+    int runConsoleComparisons(const Options &options)
+    {
+        std::cout << "ConsoleEngine against one MonoChain per channel at " << options.sampleRate << " Hz, "
+                  << options.seconds << " s of audio per configuration" << std::endl << std::endl;
+
+        std::cout << "channels  buffer  chains ms  engine ms   speedup   max error" << std::endl;
+
+        auto allPassed = true;
+
+        for (auto numChannels : options.consoleChannels)
+        {
+            for (auto bufferSize : options.bufferSizes)
+            {
+                auto result = runConsoleComparison(numChannels, bufferSize, options);
+                auto speedup = result.chainSeconds / juce::jmax(1.0e-9, result.engineSeconds);
+                auto passed = speedup >= consoleTargetSpeedup && result.maxError <= consoleErrorLimit;
+                allPassed = allPassed && passed;
+
+                std::cout << juce::String(numChannels).paddedLeft(' ', 8)
+                          << juce::String(bufferSize).paddedLeft(' ', 8)
+                          << juce::String(1000.0 * result.chainSeconds, 1).paddedLeft(' ', 11)
+                          << juce::String(1000.0 * result.engineSeconds, 1).paddedLeft(' ', 11)
+                          << juce::String(speedup, 2).paddedLeft(' ', 9) << "x"
+                          << juce::String(result.maxError, 8).paddedLeft(' ', 12)
+                          << (passed ? "  ok" : "  FAILED") << std::endl;
+            }
+        }
+
+        std::cout << std::endl << "target: at least " << consoleTargetSpeedup << "x, error below " << consoleErrorLimit << std::endl;
+        return allPassed ? 0 : 1;
+    }
+
+    //==============================================================================
+    struct LowBandSettings
+    {
+        const char *name;
+        ChainSettings settings;
+    };
+
+    // Low bands of the kind the multirate path is for. The rest of the chain stays at its defaults, the same on both sides.
+    std::vector<LowBandSettings> makeLowBandSettings()
+    {
+        std::vector<LowBandSettings> list;
+
+        ChainSettings rumble;
+        rumble.lowCutFreq = 30.f;
+        rumble.lowCutSlope = Slope_48;
+        list.push_back({ "48 dB/oct cut at 30 Hz", rumble });
+
+        ChainSettings steep = rumble;
+        steep.lowCutSlope = Slope_96;
+        list.push_back({ "96 dB/oct cut at 30 Hz", steep });
+
+        ChainSettings lows = rumble;
+        lows.peakFreq = 80.f;
+        lows.peakGainInDecibels = 4.f;
+        lows.midFreq = 200.f;
+        lows.midGainInDecibels = -3.f;
+        list.push_back({ "cut, Peak 80 Hz, Mid 200 Hz", lows });
+
+        return list;
+    }
+
+    struct LowBandResult
+    {
+        double chainSeconds = 0, lowBandSeconds = 0;
+        double chainErrorDecibels = -200, lowBandErrorDecibels = -200; // largest difference from the chain in double, relative to its peak
+        MultirateLowBand::Routing routing;
+    };
+
+    // The full rate chain against the chain with the moved bands bypassed plus the low band, as the plugin runs them.
+    // Both are checked against the same sections run in double at the full rate, since at these rates it's the float
+    // chain whose poles are crowded against z = 1.
+    LowBandResult runLowBandComparison(const ChainSettings &settings, double sampleRate, int bufferSize, double seconds)
+    {
+        auto numBlocks = juce::jmax(1, juce::roundToInt(seconds * sampleRate / bufferSize));
+        const int sourceBlocks = 64;
+
+        juce::AudioBuffer<float> source(1, bufferSize * sourceBlocks);
+        juce::Random random(bufferSize);
+        for (int i = 0; i < source.getNumSamples(); ++i)
+            source.setSample(0, i, (random.nextFloat() * 2.f - 1.f) * 0.25f);
+
+        MonoChain fullRate, remaining;
+        for (auto *chain : { &fullRate, &remaining })
+        {
+            chain->prepare({ sampleRate, (juce::uint32) bufferSize, 1 });
+            updateChain(*chain, settings, sampleRate);
+        }
+
+        MultirateLowBand lowBand;
+        lowBand.prepare(sampleRate);
+
+        LowBandResult result;
+        result.routing = lowBand.route(settings);
+        lowBand.setSections(settings, result.routing);
+        remaining.setBypassed<ChainPositions::LowCut>(result.routing.lowCut);
+        remaining.setBypassed<ChainPositions::Peak>(result.routing.peak);
+        remaining.setBypassed<ChainPositions::Mid>(result.routing.mid);
+
+        BiquadCoefficients sections[maxChainSections];
+        double state[maxChainSections][2] {};
+        auto numSections = makeChainBiquads(settings, sampleRate, sections);
+
+        // The low band's output is late by its latency, so it's compared against the reference from that long ago
+        auto latency = lowBand.getLatencySamples();
+        std::vector<double> reference((size_t) (latency + bufferSize), 0.0);
+        juce::AudioBuffer<float> chainBuffer(1, bufferSize), lowBandBuffer(1, bufferSize);
+        double chainError = 0, lowBandError = 0, peak = 0;
+
+        juce::ScopedNoDenormals noDenormals;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            auto sourceOffset = (block % sourceBlocks) * bufferSize;
+            chainBuffer.copyFrom(0, 0, source, 0, sourceOffset, bufferSize);
+            lowBandBuffer.copyFrom(0, 0, source, 0, sourceOffset, bufferSize);
+
+            juce::dsp::AudioBlock<float> chainBlock(chainBuffer), lowBandBlock(lowBandBuffer);
+
+            auto start = juce::Time::getHighResolutionTicks();
+            fullRate.process(juce::dsp::ProcessContextReplacing<float>(chainBlock));
+            auto middle = juce::Time::getHighResolutionTicks();
+            remaining.process(juce::dsp::ProcessContextReplacing<float>(lowBandBlock));
+            lowBand.process(lowBandBuffer.getWritePointer(0), bufferSize);
+            auto end = juce::Time::getHighResolutionTicks();
+
+            result.chainSeconds += juce::Time::highResolutionTicksToSeconds(middle - start);
+            result.lowBandSeconds += juce::Time::highResolutionTicksToSeconds(end - middle);
+
+            std::copy(reference.begin() + bufferSize, reference.end(), reference.begin());
+            auto *newest = reference.data() + latency;
+            std::copy(source.getReadPointer(0, sourceOffset), source.getReadPointer(0, sourceOffset) + bufferSize, newest);
+            for (int k = 0; k < numSections; ++k)
+                processBiquad(sections[k], state[k][0], state[k][1], newest, bufferSize);
+
+            if (block * bufferSize < latency + (int) sampleRate / 10) // a moment for both to settle
+                continue;
+
+            for (int i = 0; i < bufferSize; ++i)
+            {
+                chainError = juce::jmax(chainError, std::abs((double) chainBuffer.getSample(0, i) - newest[i]));
+                lowBandError = juce::jmax(lowBandError, std::abs((double) lowBandBuffer.getSample(0, i) - reference[(size_t) i]));
+                peak = juce::jmax(peak, std::abs(newest[i]));
+            }
+        }
+
+        result.chainErrorDecibels = juce::Decibels::gainToDecibels(chainError / juce::jmax(1.0e-12, peak), -200.0);
+        result.lowBandErrorDecibels = juce::Decibels::gainToDecibels(lowBandError / juce::jmax(1.0e-12, peak), -200.0);
+        return result;
+    }
+
+    // The half-band filters only have to keep the moved bands within route()'s 0.01 dB, so this is a sanity check
+    // rather than a precision target. Speed isn't pass/fail: the filters cost about as much as four full rate
+    // sections, so only heavier low bands come out ahead.
+    constexpr double lowBandErrorLimit = -40.0;
+
+    int runLowBandComparisons(const Options &options)
+    {
+        juce::Array<double> sampleRates { 176400.0, 192000.0, 352800.0, 384000.0 };
+        if (options.sampleRate >= MultirateLowBand::minimumSampleRate)
+            sampleRates = { options.sampleRate };
+
+        std::cout << "Multirate low band against the same bands at the full rate, " << options.seconds << " s of audio per configuration" << std::endl << std::endl;
+        std::cout << "    rate  buffer  moved  chain ns/sample  low band ns/sample   speedup  chain dB  low band dB   settings" << std::endl;
+
+        auto allPassed = true;
+
+        for (auto sampleRate : sampleRates)
+        {
+            for (auto bufferSize : options.bufferSizes)
+            {
+                for (auto &test : makeLowBandSettings())
+                {
+                    auto result = runLowBandComparison(test.settings, sampleRate, bufferSize, options.seconds);
+                    auto numSamples = double(juce::jmax(1, juce::roundToInt(options.seconds * sampleRate / bufferSize)) * bufferSize);
+                    auto speedup = result.chainSeconds / juce::jmax(1.0e-9, result.lowBandSeconds);
+                    auto passed = result.lowBandErrorDecibels <= juce::jmax(lowBandErrorLimit, result.chainErrorDecibels);
+                    allPassed = allPassed && passed;
+
+                    juce::String moved;
+                    moved << (result.routing.lowCut ? "C" : "-") << (result.routing.peak ? "P" : "-") << (result.routing.mid ? "M" : "-");
+
+                    std::cout << juce::String(sampleRate / 1000.0, 1).paddedLeft(' ', 8)
+                              << juce::String(bufferSize).paddedLeft(' ', 8)
+                              << moved.paddedLeft(' ', 7)
+                              << juce::String(1.0e9 * result.chainSeconds / numSamples, 2).paddedLeft(' ', 17)
+                              << juce::String(1.0e9 * result.lowBandSeconds / numSamples, 2).paddedLeft(' ', 20)
+                              << juce::String(speedup, 2).paddedLeft(' ', 9) << "x"
+                              << juce::String(result.chainErrorDecibels, 1).paddedLeft(' ', 10)
+                              << juce::String(result.lowBandErrorDecibels, 1).paddedLeft(' ', 13)
+                              << "   " << test.name
+                              << (passed ? "  ok" : "  FAILED") << std::endl;
+                }
+            }
+        }
+
+        std::cout << std::endl << "errors against the chain run in double; the low band passes below " << lowBandErrorLimit
+                  << " dB or the float chain's own error" << std::endl;
+        return allPassed ? 0 : 1;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser; // the graph rebuilds itself synchronously only on the message thread
+
+    juce::ArgumentList args(argc, argv);
+    Options options;
+
+    options.graphFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.containsOption("--graph") ? args.getValueForOption("--graph")
+                                                                                                             : juce::String("PluginTestHost.filtergraph"));
+    if (args.containsOption("--instances"))
+        options.instanceCounts = parseList(args.getValueForOption("--instances"));
+    if (args.containsOption("--buffers"))
+        options.bufferSizes = parseList(args.getValueForOption("--buffers"));
+    if (args.containsOption("--rate"))
+        options.sampleRate = args.getValueForOption("--rate").getDoubleValue();
+    if (args.containsOption("--seconds"))
+        options.seconds = args.getValueForOption("--seconds").getDoubleValue();
+
+    if (args.containsOption("--console"))
+    {
+        options.consoleChannels = parseList(args.getValueForOption("--console"));
+        if (options.consoleChannels.isEmpty())
+            options.consoleChannels = { 16, 64, 256 };
+
+        return runConsoleComparisons(options);
+    }
+
+    if (args.containsOption("--low-band"))
+        return runLowBandComparisons(options);
+
+    auto state = options.graphFile.existsAsFile() ? loadStateFromGraph(options.graphFile) : juce::MemoryBlock();
+
+    std::cout << "FiltEQ load test at " << options.sampleRate << " Hz, " << options.seconds << " s of audio per configuration" << std::endl;
+    std::cout << (state.getSize() > 0 ? "Using the FiltEQ state from " + options.graphFile.getFullPathName()
+                                      : juce::String("No FiltEQ state found, using default parameters")) << std::endl << std::endl;
+
+    std::cout << "instances  buffer     cpu %   us/instance/block   worst block %   deadline misses %" << std::endl;
+
+    for (auto numInstances : options.instanceCounts)
+    {
+        for (auto bufferSize : options.bufferSizes)
+        {
+            auto result = runConfiguration(numInstances, bufferSize, options, state);
+
+            std::cout << juce::String(numInstances).paddedLeft(' ', 9)
+                      << juce::String(bufferSize).paddedLeft(' ', 8)
+                      << juce::String(100.0 * result.cpuLoad, 2).paddedLeft(' ', 10)
+                      << juce::String(result.microsPerInstance, 3).paddedLeft(' ', 20)
+                      << juce::String(100.0 * result.worstBlockLoad, 1).paddedLeft(' ', 16)
+                      << juce::String(100.0 * result.missRate, 3).paddedLeft(' ', 20) << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,323 @@
+/*
+  ==============================================================================
+
+    Python bindings to the DSP core, for running FiltEQ settings over large
+    amounts of audio without a host:
+
+        import numpy as np, filteq
+
+        settings = filteq.ChainSettings.fromParameters({"Peak Gain": 6, "Low Cut Freq": 80})
+        processor = filteq.Processor(48000, 2, settings)
+        processor.process(audio)              # (frames, channels), filtered in place
+        sos = filteq.makeLowCutFilter(settings, 48000)  # scipy.signal second-order sections
+
+    Processor.process() works on the caller's float32 or float64 array through its
+    strides, so nothing is copied whatever the layout, and it releases the GIL while
+    it runs: one processor per worker thread scales across cores. The designs are
+    the BiquadDesign ones, which match the plugin's; the filtering accumulates in
+    double whatever the sample type.
+
+  ==============================================================================
+*/
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <mutex>
+#include "DSP/BiquadDesign.h"
+
+namespace py = pybind11;
+
+namespace
+{
+    // One row per section in scipy's sos layout: b0, b1, b2, a0, a1, a2
+    py::array_t<double> toSos(const BiquadCoefficients *sections, int numSections)
+    {
+        py::array_t<double> sos(std::vector<py::ssize_t> { numSections, 6 });
+        auto rows = sos.mutable_unchecked<2>();
+
+        for (int i = 0; i < numSections; ++i)
+        {
+            const auto &s = sections[i];
+            const double row[6] = { s.b0, s.b1, s.b2, 1.0, s.a1, s.a2 };
+            for (int j = 0; j < 6; ++j)
+                rows(i, j) = row[j];
+        }
+
+        return sos;
+    }
+
+    // For constructor arguments, checked before anything is sized from them
+    template<typename Number>
+    Number requirePositive(Number value, const char *name)
+    {
+        if (!(value > 0)) // NaN too
+            throw py::value_error(std::string(name) + " must be greater than 0");
+
+        return value;
+    }
+
+    //==============================================================================
+    // The chain for any number of channels, run on strided samples so any NumPy layout is filtered where it lies.
+    // Slots follow MonoChain (as in InterleavedChain); flat and unused ones are skipped.
+    class StreamingChain
+    {
+    public:
+        StreamingChain(double newSampleRate, int newNumChannels, const ChainSettings &chainSettings)
+            : sampleRate(requirePositive(newSampleRate, "sampleRate")), numChannels(requirePositive(newNumChannels, "numChannels")),
+              state((size_t) (2 * maxChainSections * numChannels), 0.0)
+        {
+            setSettings(chainSettings);
+        }
+
+        // Keeps the filter state, so settings can change between blocks of a stream without a gap
+        void setSettings(const ChainSettings &chainSettings)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            settings = chainSettings;
+            for (auto &section : sections)
+            {
+                section.wasActive = section.isActive();
+                section.used = false;
+            }
+
+            BiquadCoefficients designed[maxCutSections];
+            auto numLowCut = makeLowCutBiquads(settings, sampleRate, designed);
+            for (int i = 0; i < numLowCut; ++i)
+                setSection(i, designed[i]);
+
+            setSection(peakSlot, makePeakBiquad(settings, sampleRate));
+
+            auto numHighCut = makeHighCutBiquads(settings, sampleRate, designed);
+            for (int i = 0; i < numHighCut; ++i)
+                setSection(highCutSlot + i, designed[i]);
+
+            setSection(midSlot, makeMidBiquad(settings, sampleRate));
+        }
+
+        ChainSettings getSettings() const
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            return settings;
+        }
+
+        void reset()
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            std::fill(state.begin(), state.end(), 0.0);
+        }
+
+        // Strides are in samples. Called without the GIL; the lock only keeps two threads off one processor.
+        template<typename Sample>
+        void process(Sample *data, py::ssize_t numFrames, py::ssize_t frameStride, py::ssize_t channelStride)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            for (int slot = 0; slot < maxChainSections; ++slot)
+            {
+                if (!sections[slot].isActive())
+                    continue;
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    auto &s1 = state[(size_t) (2 * (slot * numChannels + channel))];
+                    auto &s2 = state[(size_t) (2 * (slot * numChannels + channel) + 1)];
+                    processBiquad(sections[slot].coefficients, s1, s2, data + channel * channelStride, numFrames, frameStride);
+                }
+            }
+        }
+
+        double getSampleRate() const noexcept { return sampleRate; }
+        int getNumChannels() const noexcept { return numChannels; }
+
+    private:
+        static constexpr int peakSlot = maxCutSections;
+        static constexpr int highCutSlot = maxCutSections + 1;
+        static constexpr int midSlot = 2 * maxCutSections + 1;
+
+        struct Section
+        {
+            BiquadCoefficients coefficients;
+            bool used = false, wasActive = false;
+
+            bool isActive() const noexcept // flat sections (0 dB bands) are skipped
+            {
+                return used && !isFlat(coefficients);
+            }
+        };
+
+        void setSection(int slot, const BiquadCoefficients &coefficients)
+        {
+            auto &section = sections[slot];
+            section.coefficients = coefficients;
+            section.used = true;
+
+            // A section coming back into use (a steeper slope, a band leaving 0 dB) starts clear rather than from
+            // whatever it held when it was last run
+            if (section.isActive() && !section.wasActive)
+                std::fill(state.begin() + 2 * slot * numChannels, state.begin() + 2 * (slot + 1) * numChannels, 0.0);
+        }
+
+        const double sampleRate;
+        const int numChannels;
+        ChainSettings settings;
+        Section sections[maxChainSections];
+        std::vector<double> state; // s1, s2 per channel, per slot
+        mutable std::mutex lock;
+    };
+
+    template<typename Sample>
+    void processArray(StreamingChain &chain, py::array &buffer, int channelAxis)
+    {
+        auto typed = py::reinterpret_borrow<py::array_t<Sample>>(buffer); // the same array, its dtype already checked
+        auto *data = typed.mutable_data();
+
+        for (py::ssize_t axis = 0; axis < typed.ndim(); ++axis)
+            if (typed.strides(axis) % (py::ssize_t) sizeof(Sample) != 0)
+                throw py::value_error("the buffer's samples aren't aligned to their size");
+
+        auto elementStride = [&](int axis) { return (py::ssize_t) (typed.strides(axis) / (py::ssize_t) sizeof(Sample)); };
+
+        py::ssize_t numFrames, frameStride, channelStride = 0;
+        if (typed.ndim() == 1)
+        {
+            numFrames = typed.shape(0);
+            frameStride = elementStride(0);
+        }
+        else
+        {
+            auto frameAxis = 1 - channelAxis;
+            numFrames = typed.shape(frameAxis);
+            frameStride = elementStride(frameAxis);
+            channelStride = elementStride(channelAxis);
+        }
+
+        py::gil_scoped_release release;
+        chain.process(data, numFrames, frameStride, channelStride);
+    }
+
+    void process(StreamingChain &chain, py::array buffer, int channelAxis)
+    {
+        if (!buffer.writeable())
+            throw py::value_error("the buffer is filtered in place, so it must be writeable");
+
+        if (buffer.ndim() == 1)
+        {
+            if (chain.getNumChannels() != 1)
+                throw py::value_error("a 1-D buffer needs a processor with one channel");
+        }
+        else if (buffer.ndim() == 2)
+        {
+            if (channelAxis < 0)
+                channelAxis += 2;
+            if (channelAxis != 0 && channelAxis != 1)
+                throw py::value_error("channelAxis must be 0, 1 or -1");
+            if (buffer.shape(channelAxis) != chain.getNumChannels())
+                throw py::value_error("the buffer has " + std::to_string(buffer.shape(channelAxis)) + " channels on axis "
+                                      + std::to_string(channelAxis) + ", the processor " + std::to_string(chain.getNumChannels()));
+        }
+        else
+        {
+            throw py::value_error("expected a 1-D or 2-D buffer");
+        }
+
+        // No conversion: anything else would have to be copied, and the result wouldn't land in the caller's array
+        if (py::isinstance<py::array_t<float>>(buffer))
+            processArray<float>(chain, buffer, channelAxis);
+        else if (py::isinstance<py::array_t<double>>(buffer))
+            processArray<double>(chain, buffer, channelAxis);
+        else
+            throw py::type_error("expected a float32 or float64 array");
+    }
+}
+
+//==============================================================================
+PYBIND11_MODULE(filteq, module)
+{
+    module.doc() = "FiltEQ's filter chain and coefficient design";
+
+    py::enum_<Slope>(module, "Slope")
+        .value("Slope_12", Slope_12)
+        .value("Slope_24", Slope_24)
+        .value("Slope_36", Slope_36)
+        .value("Slope_48", Slope_48)
+        .value("Slope_60", Slope_60)
+        .value("Slope_72", Slope_72)
+        .value("Slope_84", Slope_84)
+        .value("Slope_96", Slope_96)
+        .export_values();
+
+    py::class_<ChainSettings>(module, "ChainSettings", "Parameter settings, defaulting to the plugin's parameter defaults")
+        .def(py::init<>())
+        .def_static("fromParameters", [](const std::map<std::string, float> &parameters)
+        {
+            ChainSettings settings;
+            for (const auto &parameter : parameters)
+                if (!setChainParameter(settings, juce::String(parameter.first), parameter.second))
+                    throw py::key_error("unknown parameter ID: " + parameter.first);
+            return settings;
+        }, py::arg("parameters"), "Settings from plugin parameter IDs, e.g. {\"Peak Gain\": 3}; missing ones keep their defaults")
+        .def_readwrite("midFreq", &ChainSettings::midFreq)
+        .def_readwrite("midGainInDecibels", &ChainSettings::midGainInDecibels)
+        .def_readwrite("midQuality", &ChainSettings::midQuality)
+        .def_readwrite("peakFreq", &ChainSettings::peakFreq)
+        .def_readwrite("peakGainInDecibels", &ChainSettings::peakGainInDecibels)
+        .def_readwrite("peakQuality", &ChainSettings::peakQuality)
+        .def_readwrite("lowCutFreq", &ChainSettings::lowCutFreq)
+        .def_readwrite("highCutFreq", &ChainSettings::highCutFreq)
+        .def_readwrite("lowCutSlope", &ChainSettings::lowCutSlope)
+        .def_readwrite("highCutSlope", &ChainSettings::highCutSlope)
+        .def("__eq__", [](const ChainSettings &a, const ChainSettings &b) { return a == b; })
+        .def("__repr__", [](const ChainSettings &s)
+        {
+            return "ChainSettings(lowCut=" + std::to_string(s.lowCutFreq) + " Hz/" + std::to_string(12 * (s.lowCutSlope + 1)) + " dB"
+                 + ", peak=" + std::to_string(s.peakFreq) + " Hz " + std::to_string(s.peakGainInDecibels) + " dB Q" + std::to_string(s.peakQuality)
+                 + ", mid=" + std::to_string(s.midFreq) + " Hz " + std::to_string(s.midGainInDecibels) + " dB Q" + std::to_string(s.midQuality)
+                 + ", highCut=" + std::to_string(s.highCutFreq) + " Hz/" + std::to_string(12 * (s.highCutSlope + 1)) + " dB)";
+        });
+
+    module.def("makePeakFilter", [](const ChainSettings &settings, double sampleRate)
+    {
+        auto section = makePeakBiquad(settings, sampleRate);
+        return toSos(&section, 1);
+    }, py::arg("settings"), py::arg("sampleRate"), "The Peak band as one second-order section, shape (1, 6)");
+
+    module.def("makeMidFilter", [](const ChainSettings &settings, double sampleRate)
+    {
+        auto section = makeMidBiquad(settings, sampleRate);
+        return toSos(&section, 1);
+    }, py::arg("settings"), py::arg("sampleRate"), "The Mid band as one second-order section, shape (1, 6)");
+
+    module.def("makeLowCutFilter", [](const ChainSettings &settings, double sampleRate)
+    {
+        BiquadCoefficients sections[maxCutSections];
+        return toSos(sections, makeLowCutBiquads(settings, sampleRate, sections));
+    }, py::arg("settings"), py::arg("sampleRate"), "The low cut's Butterworth cascade, one section per 12 dB/oct");
+
+    module.def("makeHighCutFilter", [](const ChainSettings &settings, double sampleRate)
+    {
+        BiquadCoefficients sections[maxCutSections];
+        return toSos(sections, makeHighCutBiquads(settings, sampleRate, sections));
+    }, py::arg("settings"), py::arg("sampleRate"), "The high cut's Butterworth cascade, one section per 12 dB/oct");
+
+    module.def("makeChainFilter", [](const ChainSettings &settings, double sampleRate)
+    {
+        BiquadCoefficients sections[maxChainSections];
+        return toSos(sections, makeChainBiquads(settings, sampleRate, sections));
+    }, py::arg("settings"), py::arg("sampleRate"), "Every section of the chain in the plugin's order (low cut, Peak, high cut, Mid)");
+
+    py::class_<StreamingChain>(module, "Processor", "Streaming filter for one signal of any number of channels; state carries over between calls")
+        .def(py::init<double, int, const ChainSettings&>(), py::arg("sampleRate"), py::arg("numChannels"), py::arg("settings") = ChainSettings())
+        .def_property("settings", &StreamingChain::getSettings, &StreamingChain::setSettings)
+        .def_property_readonly("sampleRate", &StreamingChain::getSampleRate)
+        .def_property_readonly("numChannels", &StreamingChain::getNumChannels)
+        .def("reset", &StreamingChain::reset, "Clears the filter state, for starting an unrelated signal")
+        .def("process", [](StreamingChain &chain, py::array buffer, int channelAxis)
+        {
+            process(chain, buffer, channelAxis);
+            return buffer;
+        }, py::arg("buffer"), py::arg("channelAxis") = -1,
+           "Filters a float32 or float64 array in place (and returns it), without the GIL. 2-D buffers are (frames, channels) by default; "
+           "pass channelAxis=0 for (channels, frames).");
+}
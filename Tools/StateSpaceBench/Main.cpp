@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    State-space engine check and benchmark: for a range of settings, from the
+    default two-section chain up to 96 dB/oct cuts on both ends, runs
+    BlockStateSpaceFilter::validate() against MonoChain, then times both
+    engines rendering the same mono noise.
+
+    The exit code says whether every setting validated, so this can run as a
+    check after changes to the design or the optimiser.
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include "DSP/StateSpaceFilter.h"
+
+namespace
+{
+    struct Options
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        double seconds = 10.0;
+    };
+
+    struct NamedSettings
+    {
+        const char *name;
+        ChainSettings settings;
+    };
+
+    std::vector<NamedSettings> makeTestSettings()
+    {
+        std::vector<NamedSettings> list;
+        list.push_back({ "defaults", ChainSettings{} });
+
+        ChainSettings mix;
+        mix.lowCutFreq = 40.f;
+        mix.lowCutSlope = Slope_24;
+        mix.peakFreq = 3200.f;
+        mix.peakGainInDecibels = 4.5f;
+        mix.midFreq = 300.f;
+        mix.midGainInDecibels = -3.f;
+        mix.midQuality = 1.4f;
+        mix.highCutFreq = 16000.f;
+        mix.highCutSlope = Slope_12;
+        list.push_back({ "mix bus", mix });
+
+        ChainSettings steep = mix;
+        steep.lowCutSlope = Slope_48;
+        steep.highCutSlope = Slope_48;
+        list.push_back({ "48 dB/oct cuts", steep });
+
+        ChainSettings steepest = mix;
+        steepest.lowCutSlope = Slope_96;
+        steepest.highCutSlope = Slope_96;
+        list.push_back({ "96 dB/oct cuts", steepest });
+
+        // Everything near DC at once, where the matrix powers are closest to ill-conditioned
+        ChainSettings low;
+        low.lowCutFreq = 20.f;
+        low.lowCutSlope = Slope_48;
+        low.peakFreq = 30.f;
+        low.peakGainInDecibels = 24.f;
+        low.peakQuality = 10.f;
+        low.midFreq = 60.f;
+        low.midGainInDecibels = -24.f;
+        low.highCutFreq = 200.f;
+        low.highCutSlope = Slope_48;
+        list.push_back({ "sub bass", low });
+
+        return list;
+    }
+
+    // Nanoseconds per sample for MonoChain and the state-space filter over the same signal, in blocks of the given size
+    std::pair<double, double> time(const ChainSettings &settings, const Options &options)
+    {
+        auto numSamples = juce::jmax(options.blockSize, juce::roundToInt(options.seconds * options.sampleRate));
+        auto numBlocks = numSamples / options.blockSize;
+
+        juce::AudioBuffer<float> source(1, 1 << 16);
+        juce::Random random(42);
+        for (int i = 0; i < source.getNumSamples(); ++i)
+            source.setSample(0, i, (random.nextFloat() * 2.f - 1.f) * 0.25f);
+
+        MonoChain chain;
+        chain.prepare({ options.sampleRate, (juce::uint32) options.blockSize, 1 });
+        updateChain(chain, settings, options.sampleRate);
+
+        BlockStateSpaceFilter filter;
+        filter.setChainSettings(settings, options.sampleRate);
+
+        juce::AudioBuffer<float> buffer(1, options.blockSize);
+        auto sourceBlocks = source.getNumSamples() / options.blockSize;
+
+        juce::ScopedNoDenormals noDenormals;
+
+        auto start = juce::Time::getHighResolutionTicks();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            buffer.copyFrom(0, 0, source, 0, (b % sourceBlocks) * options.blockSize, options.blockSize);
+            juce::dsp::AudioBlock<float> block(buffer);
+            juce::dsp::ProcessContextReplacing<float> context(block);
+            chain.process(context);
+        }
+        auto chainSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+        start = juce::Time::getHighResolutionTicks();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            buffer.copyFrom(0, 0, source, 0, (b % sourceBlocks) * options.blockSize, options.blockSize);
+            filter.process(buffer.getWritePointer(0), options.blockSize);
+        }
+        auto filterSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+        auto total = double(numBlocks * options.blockSize);
+        return { 1.0e9 * chainSeconds / total, 1.0e9 * filterSeconds / total };
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    Options options;
+
+    if (args.containsOption("--rate"))
+        options.sampleRate = args.getValueForOption("--rate").getDoubleValue();
+    if (args.containsOption("--block"))
+        options.blockSize = juce::jmax(1, args.getValueForOption("--block").getIntValue());
+    if (args.containsOption("--seconds"))
+        options.seconds = args.getValueForOption("--seconds").getDoubleValue();
+
+    std::cout << "FiltEQ state-space engine at " << options.sampleRate << " Hz, " << options.blockSize << " sample blocks" << std::endl << std::endl;
+
+    auto allPassed = true;
+
+    for (auto &test : makeTestSettings())
+    {
+        auto result = BlockStateSpaceFilter::validate(test.settings, options.sampleRate);
+        allPassed = allPassed && result.passed;
+
+        auto peak = juce::jmax(1.0e-12, result.referencePeak);
+        std::cout << test.name << std::endl
+                  << "  error " << juce::String(juce::Decibels::gainToDecibels(result.maxError / peak, -200.0), 1) << " dB"
+                  << "  (MonoChain " << juce::String(juce::Decibels::gainToDecibels(result.referenceError / peak, -200.0), 1) << " dB)"
+                  << (result.passed ? "  ok" : "  FAILED") << std::endl;
+
+        auto timings = time(test.settings, options);
+        std::cout << "  MonoChain " << juce::String(timings.first, 2) << " ns/sample, state-space " << juce::String(timings.second, 2)
+                  << " ns/sample (" << juce::String(timings.first / timings.second, 2) << "x faster)" << std::endl << std::endl;
+    }
+
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,320 @@
+/*
+  ==============================================================================
+
+    Headless streaming filter: reads interleaved raw PCM from stdin (or a named
+    pipe), runs it through the FiltEQ chain in small fixed blocks and writes the
+    same format to stdout, so it can sit in a sox/ffmpeg pipeline:
+
+        ffmpeg -i in.wav -f s24le -ac 2 - | FiltEQStream --format s24 --preset eq.json | ...
+
+    Samples are little-endian s16, packed s24 or f32, any number of channels.
+    Settings come from a JSON object of parameter IDs to values ({"Peak Gain": 3,
+    ...}, missing ones keep their defaults) or from a state blob saved by the
+    plugin. Sending SIGHUP re-reads the preset between two blocks; the filter
+    state carries over, so nothing is dropped or restarted.
+
+    Only the GUI-free DSP core is linked: no AudioProcessor and no AudioBuffer,
+    the chain runs straight on the interleaved samples. A mono stream can run
+    through BlockStateSpaceFilter instead (--state-space), which is faster for
+    steep cuts; FiltEQStateSpaceBench times both for a given setting.
+
+  ==============================================================================
+*/
+
+#include <signal.h>
+#include <cstdio>
+#include <iostream>
+#include "DSP/InterleavedChain.h"
+#include "DSP/StateSpaceFilter.h"
+
+#if JUCE_WINDOWS
+ #include <fcntl.h>
+ #include <io.h>
+#endif
+
+namespace
+{
+    enum class SampleFormat
+    {
+        s16, s24, f32
+    };
+
+    struct Options
+    {
+        SampleFormat format = SampleFormat::f32;
+        int numChannels = 2;
+        double sampleRate = 48000.0;
+        int blockSize = 64;
+        juce::File preset, input;
+        bool flushEveryBlock = false;
+        bool stateSpace = false; // mono only
+    };
+
+    std::atomic<bool> reloadRequested {false};
+
+    extern "C" void requestReload(int)
+    {
+        reloadRequested = true;
+    }
+
+    int getBytesPerSample(SampleFormat format)
+    {
+        return format == SampleFormat::s16 ? 2 : (format == SampleFormat::s24 ? 3 : 4);
+    }
+
+    //==============================================================================
+    // The DSP core doesn't include juce_data_structures, so a plugin state blob is read here directly. It's what
+    // ValueTree::writeToStream produces: type, properties, then children, with the parameters in PARAM children.
+    bool readStateTree(juce::MemoryInputStream &stream, ChainSettings &settings, int depth)
+    {
+        auto type = stream.readString();
+        if (type.isEmpty() || depth > 8)
+            return false;
+
+        auto numProperties = stream.readCompressedInt();
+        if (numProperties < 0)
+            return false;
+
+        juce::String id;
+        juce::var value;
+        for (int i = 0; i < numProperties; ++i)
+        {
+            auto name = stream.readString();
+            auto property = juce::var::readFromStream(stream);
+
+            if (name == "id")
+                id = property.toString();
+            else if (name == "value")
+                value = property;
+        }
+
+        if (type == "PARAM" && id.isNotEmpty() && !value.isVoid())
+            setChainParameter(settings, id, (float) value);
+
+        auto numChildren = stream.readCompressedInt();
+        if (numChildren < 0)
+            return false;
+
+        for (int i = 0; i < numChildren; ++i)
+            if (!readStateTree(stream, settings, depth + 1))
+                return false;
+
+        return true;
+    }
+
+    bool loadPreset(const juce::File &file, ChainSettings &settings, juce::String &error)
+    {
+        juce::MemoryBlock data;
+        if (!file.loadFileAsData(data))
+        {
+            error = "can't read " + file.getFullPathName();
+            return false;
+        }
+
+        ChainSettings loaded;
+        auto text = data.toString().trimStart();
+
+        if (text.startsWithChar('{'))
+        {
+            auto json = juce::JSON::parse(text);
+            auto *object = json.getDynamicObject();
+            if (object == nullptr)
+            {
+                error = file.getFileName() + " isn't a JSON object";
+                return false;
+            }
+
+            for (auto &property : object->getProperties())
+                if (!setChainParameter(loaded, property.name.toString(), (float) property.value))
+                    std::cerr << "Ignoring unknown parameter \"" << property.name.toString() << "\"" << std::endl;
+        }
+        else
+        {
+            juce::MemoryInputStream stream(data, false);
+            if (!readStateTree(stream, loaded, 0))
+            {
+                error = file.getFileName() + " is neither a JSON preset nor a FiltEQ state";
+                return false;
+            }
+        }
+
+        settings = loaded;
+        return true;
+    }
+
+    //==============================================================================
+    void toFloat(const char *bytes, float *samples, int numSamples, SampleFormat format)
+    {
+        if (format == SampleFormat::s16)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                samples[i] = (float) (juce::int16) juce::ByteOrder::littleEndianShort(bytes + 2 * i) * (1.f / 32768.f);
+        }
+        else if (format == SampleFormat::s24)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                samples[i] = (float) juce::ByteOrder::littleEndian24Bit(bytes + 3 * i) * (1.f / 8388608.f);
+        }
+        else
+        {
+            std::memcpy(samples, bytes, sizeof(float) * (size_t) numSamples);
+        }
+    }
+
+    void fromFloat(const float *samples, char *bytes, int numSamples, SampleFormat format)
+    {
+        if (format == SampleFormat::s16)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto value = juce::ByteOrder::swapIfBigEndian((juce::uint16) juce::jlimit(-32768, 32767, juce::roundToInt(samples[i] * 32768.f)));
+                std::memcpy(bytes + 2 * i, &value, 2);
+            }
+        }
+        else if (format == SampleFormat::s24)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                juce::ByteOrder::littleEndian24BitToChars(juce::jlimit(-8388608, 8388607, juce::roundToInt(samples[i] * 8388608.f)), bytes + 3 * i);
+        }
+        else
+        {
+            std::memcpy(bytes, samples, sizeof(float) * (size_t) numSamples);
+        }
+    }
+
+    bool parseOptions(const juce::ArgumentList &args, Options &options)
+    {
+        if (args.containsOption("--format"))
+        {
+            auto format = args.getValueForOption("--format");
+            if (format == "s16")       options.format = SampleFormat::s16;
+            else if (format == "s24")  options.format = SampleFormat::s24;
+            else if (format == "f32")  options.format = SampleFormat::f32;
+            else                       return false;
+        }
+
+        if (args.containsOption("--channels"))
+            options.numChannels = args.getValueForOption("--channels").getIntValue();
+        if (args.containsOption("--rate"))
+            options.sampleRate = args.getValueForOption("--rate").getDoubleValue();
+        if (args.containsOption("--block"))
+            options.blockSize = args.getValueForOption("--block").getIntValue();
+        if (args.containsOption("--preset"))
+            options.preset = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--preset"));
+        if (args.containsOption("--input"))
+            options.input = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--input"));
+
+        options.flushEveryBlock = args.containsOption("--flush");
+        options.stateSpace = args.containsOption("--state-space");
+
+        return options.numChannels > 0 && options.sampleRate > 0 && options.blockSize > 0
+            && (!options.stateSpace || options.numChannels == 1);
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    Options options;
+
+    if (!parseOptions(args, options))
+    {
+        std::cerr << "usage: FiltEQStream [--format s16|s24|f32] [--channels 2] [--rate 48000] [--block 64]" << std::endl
+                  << "                    [--preset preset.json|state.bin] [--input fifo] [--flush]" << std::endl
+                  << "                    [--state-space] (with --channels 1)" << std::endl;
+        return 2;
+    }
+
+    ChainSettings settings;
+    juce::String error;
+    if (options.preset != juce::File() && !loadPreset(options.preset, settings, error))
+    {
+        std::cerr << "FiltEQStream: " << error << std::endl;
+        return 1;
+    }
+
+   #if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+    struct sigaction action {};
+    action.sa_handler = requestReload;
+    action.sa_flags = SA_RESTART; // the blocking read carries on after the signal instead of coming back short
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGHUP, &action, nullptr);
+   #endif
+
+   #if JUCE_WINDOWS
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+   #endif
+
+    auto *input = stdin;
+    if (options.input != juce::File())
+    {
+        input = std::fopen(options.input.getFullPathName().toRawUTF8(), "rb"); // blocks until a writer opens a FIFO
+        if (input == nullptr)
+        {
+            std::cerr << "FiltEQStream: can't open " << options.input.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    InterleavedChain chain;
+    chain.prepare(options.sampleRate, options.numChannels);
+    chain.setSettings(settings);
+
+    BlockStateSpaceFilter stateSpaceFilter;
+    if (options.stateSpace)
+        stateSpaceFilter.setChainSettings(settings, options.sampleRate);
+
+    auto frameBytes = (size_t) (getBytesPerSample(options.format) * options.numChannels);
+    std::vector<char> bytes(frameBytes * (size_t) options.blockSize);
+    std::vector<float> samples((size_t) (options.numChannels * options.blockSize));
+
+    juce::ScopedNoDenormals noDenormals;
+
+    for (;;)
+    {
+        // Reloading between blocks keeps every sample and the filter state; only the coefficients change
+        if (reloadRequested.exchange(false) && options.preset != juce::File())
+        {
+            if (loadPreset(options.preset, settings, error))
+            {
+                chain.setSettings(settings);
+                if (options.stateSpace)
+                    stateSpaceFilter.setChainSettings(settings, options.sampleRate);
+            }
+            else
+                std::cerr << "FiltEQStream: keeping the current settings, " << error << std::endl;
+        }
+
+        auto numBytes = std::fread(bytes.data(), 1, bytes.size(), input);
+        auto numFrames = (int) (numBytes / frameBytes);
+
+        if (numFrames > 0)
+        {
+            auto numSamples = numFrames * options.numChannels;
+
+            toFloat(bytes.data(), samples.data(), numSamples, options.format);
+            if (options.stateSpace)
+                stateSpaceFilter.process(samples.data(), numFrames);
+            else
+                chain.process(samples.data(), numFrames);
+            fromFloat(samples.data(), bytes.data(), numSamples, options.format);
+
+            if (std::fwrite(bytes.data(), frameBytes, (size_t) numFrames, stdout) != (size_t) numFrames)
+                break; // the reader went away
+
+            if (options.flushEveryBlock)
+                std::fflush(stdout);
+        }
+
+        if (numBytes < bytes.size()) // end of the stream
+            break;
+    }
+
+    std::fflush(stdout);
+    if (input != stdin)
+        std::fclose(input);
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    WorkerPool responsiveness check: while one worker is stuck in a long low
+    priority job, a high priority request (the feedback analysis, say) must
+    still be picked up within a few poll intervals by another worker, not
+    wait for the long job to end. Also reports how long an idle pool takes
+    to notice a request, which its polling back-off trades against wakeups.
+
+    Exits non-zero if either takes longer than its limit. Needs at least two
+    workers, i.e. four cores; with fewer it says so and passes.
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include "DSP/WorkerPool.h"
+
+namespace
+{
+    constexpr int longJobMilliseconds = 250;
+    constexpr double busyLimitMilliseconds = 10 * WorkerPool::pollInterval; // far below longJobMilliseconds
+    constexpr double idleLimitMilliseconds = WorkerPool::maxPollInterval + 10;
+
+    double getMilliseconds() noexcept
+    {
+        return 1000.0 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks());
+    }
+
+    class LongJob : public WorkerPool::Job
+    {
+    public:
+        std::atomic<bool> started {false}, finished {false};
+
+    private:
+        void run() override
+        {
+            started = true;
+            auto end = getMilliseconds() + longJobMilliseconds;
+            while (getMilliseconds() < end && !isCancelled())
+                juce::Thread::sleep(1);
+            finished = true;
+        }
+    };
+
+    class QuickJob : public WorkerPool::Job
+    {
+    public:
+        std::atomic<double> ranAt {0.0};
+
+    private:
+        void run() override { ranAt = getMilliseconds(); }
+    };
+
+    template<typename Condition>
+    bool waitFor(Condition condition, int timeoutMilliseconds = 2000)
+    {
+        for (auto end = getMilliseconds() + timeoutMilliseconds; !condition(); juce::Thread::sleep(1))
+            if (getMilliseconds() > end)
+                return false;
+
+        return true;
+    }
+
+    // Milliseconds from schedule() to run(), or -1 if it never ran
+    double timePickup(QuickJob &job)
+    {
+        job.ranAt = 0.0;
+        auto requestedAt = getMilliseconds();
+        job.schedule(WorkerPool::Priority::high);
+
+        if (!waitFor([&job] { return job.ranAt.load() > 0.0; }))
+            return -1.0;
+
+        return job.ranAt.load() - requestedAt;
+    }
+
+    struct Timings
+    {
+        std::vector<double> milliseconds;
+        bool missed = false;
+
+        void add(double value)
+        {
+            missed = missed || value < 0.0;
+            milliseconds.push_back(value);
+        }
+
+        double getMedian() const
+        {
+            auto sorted = milliseconds;
+            std::sort(sorted.begin(), sorted.end());
+            return sorted.empty() ? 0.0 : sorted[sorted.size() / 2];
+        }
+
+        double getMax() const { return milliseconds.empty() ? 0.0 : *std::max_element(milliseconds.begin(), milliseconds.end()); }
+
+        bool check(const char *name, double limit) const
+        {
+            auto passed = !missed && getMax() <= limit;
+            std::cout << name << ": median " << juce::String(getMedian(), 2) << " ms, worst "
+                      << (missed ? juce::String("never ran") : juce::String(getMax(), 2) + " ms")
+                      << " (limit " << juce::String(limit, 0) << " ms)" << (passed ? "  ok" : "  FAILED") << std::endl;
+            return passed;
+        }
+    };
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    auto numTrials = args.containsOption("--trials") ? juce::jmax(1, args.getValueForOption("--trials").getIntValue()) : 20;
+
+    auto pool = WorkerPool::getShared();
+    std::cout << "FiltEQ worker pool, " << pool->getNumThreads() << " workers, " << numTrials << " trials" << std::endl << std::endl;
+
+    if (pool->getNumThreads() < 2)
+    {
+        std::cout << "Only one worker on this machine, so a long job holds up everything behind it; nothing to check." << std::endl;
+        return 0;
+    }
+
+    LongJob longJob;
+    QuickJob quickJob;
+    pool->add(longJob);
+    pool->add(quickJob);
+
+    Timings busy, idle;
+    for (int trial = 0; trial < numTrials; ++trial)
+    {
+        // A request while another worker is in the middle of a long job
+        longJob.started = longJob.finished = false;
+        longJob.schedule(WorkerPool::Priority::low);
+        if (!waitFor([&longJob] { return longJob.started.load(); }))
+        {
+            busy.add(-1.0);
+            break;
+        }
+
+        busy.add(timePickup(quickJob));
+        waitFor([&longJob] { return longJob.finished.load(); });
+
+        // A request after the pool has been idle long enough to back off fully
+        juce::Thread::sleep(4 * WorkerPool::maxPollInterval);
+        idle.add(timePickup(quickJob));
+    }
+
+    pool->remove(longJob);
+    pool->remove(quickJob);
+
+    auto passed = busy.check("high priority during a long job", busyLimitMilliseconds);
+    passed = idle.check("request to an idle pool        ", idleLimitMilliseconds) && passed;
+
+    return passed ? 0 : 1;
+}